@@ -0,0 +1,346 @@
+#include "acquisition.h"
+#include "config.h"
+#include "ble_client.h"
+#include "packet_collector.h"
+#include "mirror_store.h"
+#include "time_sync.h"
+#include "poll_scheduler.h"
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/event_groups.h>
+#include <esp_coexist.h>
+#include <string.h>
+
+// Collector buffers for one poll: at most both full regions plus bitmaps
+#define ACQ_ARENA_SIZE (QhRegion::bytes + DailyRegion::bytes + 512)
+
+// One snapshot being published while the next poll fills the other
+#define ACQ_SNAPSHOTS 2
+
+// Radio handoff between the acquisition and network tasks
+#define RADIO_WANTED (1 << 0)   // acquisition task is waiting for the radio
+#define RADIO_GRANTED (1 << 1)  // network task has released it
+#define RADIO_RETURNED (1 << 2) // acquisition task is done with it
+#define ACQ_IDLE (1 << 3)       // no poll in progress, mirrors saved
+
+// ─── Module State ───────────────────────────────────────────
+
+static TaskHandle_t s_task = nullptr;
+static QueueHandle_t s_freeQueue = nullptr;  // PollSnapshot* ready to fill
+static QueueHandle_t s_readyQueue = nullptr; // PollSnapshot* ready to publish
+static EventGroupHandle_t s_radio = nullptr;
+static PollSnapshot s_pool[ACQ_SNAPSHOTS];
+RTC_DATA_ATTR static uint32_t s_cycle = 0;  // counts on across deep sleep
+static unsigned long s_nextPollAt = 0;      // millis() the next poll is due
+
+// Device ring mirrors, owned by the acquisition task (kept across polls)
+static uint8_t s_qhMirrorData[QhRegion::bytes];
+static uint8_t s_dailyMirrorData[DailyRegion::bytes];
+static RingMirror s_qhMirror;
+static RingMirror s_dailyMirror;
+static char s_mirrorDevice[18] = ""; // device whose mirrors are loaded
+
+// Per-poll buffers, reset after every poll
+static uint8_t s_arenaStorage[ACQ_ARENA_SIZE];
+static PollArena s_arena;
+
+// ─── Helpers ────────────────────────────────────────────────
+
+template <typename R>
+static void initMirror(RingMirror &m, uint8_t (&storage)[R::bytes])
+{
+    mirrorInit(m, R::startAddr, R::bytes, R::slotMs, storage);
+}
+
+// Switch the mirrors to the connected device, restoring whatever was
+// saved to flash for it, so a cold start resumes delta fetching.
+static void loadMirrors()
+{
+    const char *addr = bleTargetAddress();
+    if (strcmp(addr, s_mirrorDevice) == 0)
+        return;
+
+    mirrorInvalidate(s_qhMirror);
+    mirrorInvalidate(s_dailyMirror);
+    storeLoad(s_qhMirror, addr, "qh");
+    storeLoad(s_dailyMirror, addr, "daily");
+    strncpy(s_mirrorDevice, addr, sizeof(s_mirrorDevice) - 1);
+    s_mirrorDevice[sizeof(s_mirrorDevice) - 1] = '\0';
+}
+
+static void saveMirrors()
+{
+    if (s_mirrorDevice[0] == '\0')
+        return;
+    storeSave(s_qhMirror, s_mirrorDevice, "qh");
+    storeSave(s_dailyMirror, s_mirrorDevice, "daily");
+}
+
+// Bring a mirror up to the device's current write index, requesting only
+// the address ranges written since the last sync.
+// Returns false if any read failed; the mirror then keeps its old cursor
+// so the next cycle re-plans the same delta. If an earlier range was
+// already stored the contents no longer match that cursor, so the mirror
+// is dropped instead. An out-of-range write index also fails, and drops
+// the mirror so the next good read refetches it.
+static bool syncMirror(RingMirror &m, uint16_t newIdx, bool newLooped,
+                       const char *label)
+{
+    FetchRange ranges[MIRROR_MAX_RANGES];
+    uint8_t numRanges = mirrorPlanFetch(m, newIdx, newLooped, ranges);
+    if (numRanges == MIRROR_PLAN_INVALID)
+    {
+        // Corrupt broadcast: committing the index would read past the mirror
+        mirrorInvalidate(m);
+        return false;
+    }
+    Serial.printf("[Acq] %s idx %u -> %u: %u range(s)%s\n",
+                  label, m.idx, newIdx, numRanges, m.valid ? "" : " (full fetch)");
+
+    for (uint8_t r = 0; r < numRanges; r++)
+    {
+        PacketCollector collector;
+        if (!collectorInit(collector, ranges[r].size, s_arena))
+        {
+            Serial.printf("[Acq] %s collector init failed\n", label);
+            return false;
+        }
+
+        bool ok = bleFetchDataset(ranges[r].address, ranges[r].size, collector) &&
+                  mirrorStore(m, ranges[r], collector.buffer, collector.bufferLen);
+        collectorFree(collector, s_arena);
+        if (!ok)
+        {
+            if (r > 0)
+                mirrorInvalidate(m);
+            return false;
+        }
+    }
+
+    mirrorCommit(m, newIdx, newLooped);
+    return true;
+}
+
+// Wait until the network task has handed over the radio
+static void radioBorrow()
+{
+    xEventGroupClearBits(s_radio, RADIO_RETURNED);
+    xEventGroupSetBits(s_radio, RADIO_WANTED);
+    xEventGroupWaitBits(s_radio, RADIO_GRANTED, pdFALSE, pdFALSE, portMAX_DELAY);
+
+    // WiFi stays up: bias the coexistence scheduler towards BLE while
+    // the notification stream runs
+    if (WIFI_BLE_COEXIST)
+        esp_coex_preference_set(ESP_COEX_PREFER_BT);
+}
+
+static void radioReturn()
+{
+    if (WIFI_BLE_COEXIST)
+        esp_coex_preference_set(ESP_COEX_PREFER_BALANCE);
+
+    xEventGroupClearBits(s_radio, RADIO_WANTED | RADIO_GRANTED);
+    xEventGroupSetBits(s_radio, RADIO_RETURNED);
+}
+
+// Connect, read and sync both rings into `snap`. Leaves the link up;
+// the caller disconnects.
+static bool acquire(PollSnapshot &snap)
+{
+    // Known address: skip the scan window entirely
+    if (!bleConnectDirect())
+    {
+        if (!bleScan())
+        {
+            Serial.println("[Acq] BLE scan failed, retry next cycle");
+            return false;
+        }
+        if (!bleConnect())
+        {
+            Serial.println("[Acq] BLE connect failed, retry next cycle");
+            return false;
+        }
+    }
+
+    if (!bleReadBroadcast(snap.broadcast))
+    {
+        Serial.println("[Acq] Broadcast read failed");
+        return false;
+    }
+    // The ring indices are as of now; the slot/day layout depends on it
+    snap.readAt = timeNow();
+    schedObserve(snap.readAt, snap.broadcast.quarterHoursIdx);
+    loadMirrors();
+
+    snap.dailyOk = syncMirror(s_dailyMirror, snap.broadcast.daysIdx,
+                              snap.broadcast.daysLooped, "Daily");
+    snap.dailyAt = snap.readAt;
+    if (!snap.dailyOk)
+    {
+        // Not fatal: republish the ring as of its last sync, so the retained
+        // daily topic keeps the device's own totals. Only without a usable
+        // (dated) mirror does daily history fall back to summing QH slots.
+        snap.dailyOk = s_dailyMirror.valid && s_dailyMirror.syncedEpoch != 0;
+        snap.dailyAt = s_dailyMirror.syncedEpoch;
+        Serial.printf("[Acq] Daily fetch failed%s\n",
+                      snap.dailyOk ? ", keeping the last synced ring" : "");
+    }
+
+    // Same pause the app leaves between the two requests
+    delay(INTER_REQUEST_DELAY_MS);
+
+    if (!bleIsConnected() ||
+        !syncMirror(s_qhMirror, snap.broadcast.quarterHoursIdx,
+                    snap.broadcast.quarterHoursLooped, "QH"))
+    {
+        Serial.println("[Acq] QH fetch failed");
+        return false;
+    }
+
+    mirrorCopy(snap.qh, s_qhMirror);
+    if (snap.dailyOk)
+        mirrorCopy(snap.daily, s_dailyMirror);
+    return true;
+}
+
+static void runPoll()
+{
+    Serial.println("\n──── Starting poll cycle ────");
+    Serial.printf("Free heap: %u bytes\n", ESP.getFreeHeap());
+
+    PollSnapshot *snap = nullptr;
+    if (xQueueReceive(s_freeQueue, &snap, 0) != pdTRUE)
+    {
+        Serial.println("[Acq] Previous snapshots not published yet, skipping cycle");
+        return;
+    }
+
+    radioBorrow();
+    unsigned long start = millis();
+    snap->cycle = ++s_cycle;
+    bleResetStats();
+    bool ok = acquire(*snap);
+    bleDisconnect();
+    snap->bleMs = millis() - start;
+    snap->link = bleStats();
+    radioReturn();
+
+    if (ok)
+    {
+        Serial.printf("[Acq] Cycle %lu acquired in %lu ms (%lu/%lu packets lost on first pass)\n",
+                      (unsigned long)snap->cycle, snap->bleMs,
+                      (unsigned long)snap->link.firstPassLost,
+                      (unsigned long)snap->link.requested);
+        xQueueSend(s_readyQueue, &snap, portMAX_DELAY);
+    }
+    else
+    {
+        xQueueSend(s_freeQueue, &snap, portMAX_DELAY);
+    }
+
+    // Persist the mirrors while the network task reconnects and publishes
+    saveMirrors();
+    arenaReset(s_arena, "Acq");
+}
+
+static void acqTask(void *arg)
+{
+    Serial.printf("[Acq] Task running on core %d\n", (int)xPortGetCoreID());
+
+    // First poll starts once the network side is up
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    for (;;)
+    {
+        unsigned long start = millis();
+        xEventGroupClearBits(s_radio, ACQ_IDLE);
+        runPoll();
+
+        // Next poll just after the device's next QH boundary (or on the
+        // plain interval until the clock is set); acqRequestPoll() cuts it short
+        uint32_t wait = schedNextPollDelayMs(timeNow(), millis() - start);
+        Serial.printf("[Acq] Next poll in %lu s\n", (unsigned long)(wait / 1000));
+        s_nextPollAt = millis() + wait;
+        xEventGroupSetBits(s_radio, ACQ_IDLE);
+        if (wait > 0)
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
+    }
+}
+
+// ─── Public Functions ───────────────────────────────────────
+
+void acqStart()
+{
+    initMirror<QhRegion>(s_qhMirror, s_qhMirrorData);
+    initMirror<DailyRegion>(s_dailyMirror, s_dailyMirrorData);
+    storeInit();
+    arenaInit(s_arena, s_arenaStorage, sizeof(s_arenaStorage));
+
+    s_radio = xEventGroupCreate();
+    xEventGroupSetBits(s_radio, ACQ_IDLE);
+    s_freeQueue = xQueueCreate(ACQ_SNAPSHOTS, sizeof(PollSnapshot *));
+    s_readyQueue = xQueueCreate(ACQ_SNAPSHOTS, sizeof(PollSnapshot *));
+    for (uint8_t i = 0; i < ACQ_SNAPSHOTS; i++)
+    {
+        PollSnapshot *snap = &s_pool[i];
+        initMirror<QhRegion>(snap->qh, snap->qhData);
+        initMirror<DailyRegion>(snap->daily, snap->dailyData);
+        xQueueSend(s_freeQueue, &snap, 0);
+    }
+
+    xTaskCreatePinnedToCore(acqTask, "ble-acq", ACQ_TASK_STACK, nullptr,
+                            ACQ_TASK_PRIORITY, &s_task, ACQ_TASK_CORE);
+}
+
+void acqRequestPoll()
+{
+    if (s_task)
+        xTaskNotifyGive(s_task);
+}
+
+PollSnapshot *acqReceive(uint32_t waitMs)
+{
+    PollSnapshot *snap = nullptr;
+    if (xQueueReceive(s_readyQueue, &snap, pdMS_TO_TICKS(waitMs)) != pdTRUE)
+        return nullptr;
+    return snap;
+}
+
+void acqRelease(PollSnapshot *snap)
+{
+    if (snap)
+        xQueueSend(s_freeQueue, &snap, 0);
+}
+
+bool acqRadioWanted()
+{
+    EventBits_t bits = xEventGroupGetBits(s_radio);
+    return (bits & RADIO_WANTED) && !(bits & RADIO_GRANTED);
+}
+
+void acqRadioGrant()
+{
+    xEventGroupSetBits(s_radio, RADIO_GRANTED);
+}
+
+bool acqRadioReturned(uint32_t waitMs)
+{
+    EventBits_t bits = xEventGroupWaitBits(s_radio, RADIO_RETURNED, pdTRUE, pdFALSE,
+                                           pdMS_TO_TICKS(waitMs));
+    return (bits & RADIO_RETURNED) != 0;
+}
+
+bool acqWaitIdle(uint32_t waitMs)
+{
+    EventBits_t bits = xEventGroupWaitBits(s_radio, ACQ_IDLE, pdFALSE, pdFALSE,
+                                           pdMS_TO_TICKS(waitMs));
+    return (bits & ACQ_IDLE) != 0;
+}
+
+uint32_t acqMsUntilNextPoll()
+{
+    long remaining = (long)(s_nextPollAt - millis());
+    return remaining > 0 ? (uint32_t)remaining : 0;
+}
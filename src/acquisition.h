@@ -0,0 +1,82 @@
+#pragma once
+
+#include "config.h"
+#include "bwt_protocol.h"
+#include "ble_client.h"
+#include "ring_mirror.h"
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * Everything one BLE poll produced, handed from the acquisition task to
+ * the network task as a whole. The acquisition side fills a free snapshot
+ * and does not touch it again until the network side releases it.
+ */
+struct PollSnapshot
+{
+    uint32_t cycle;           // poll cycle number
+    BroadcastState broadcast; // device state at the start of the poll
+    time_t readAt;            // wall clock at the broadcast read (0 if unknown)
+    RingMirror qh;            // QH ring as synced this cycle
+    RingMirror daily;         // daily ring (only meaningful if dailyOk)
+    bool dailyOk;             // daily ring usable: synced now or kept from an earlier poll
+    time_t dailyAt;           // wall clock the daily ring is current as of (0 if unknown)
+    unsigned long bleMs;      // connect-to-disconnect time
+    BleLinkStats link;        // packet loss and recovery during this poll
+    uint8_t qhData[QhRegion::bytes];
+    uint8_t dailyData[DailyRegion::bytes];
+};
+
+/**
+ * Set up the ring mirrors and start the BLE acquisition task, pinned to
+ * ACQ_TASK_CORE. Call once in setup() after bleInit().
+ * The task idles until the first acqRequestPoll(), then polls every
+ * POLL_INTERVAL_MS.
+ */
+void acqStart();
+
+/**
+ * Start a poll now instead of waiting for the interval.
+ */
+void acqRequestPoll();
+
+/**
+ * Network side: take the next completed snapshot, waiting up to `waitMs`.
+ * Returns nullptr if none arrived. Hand it back with acqRelease().
+ */
+PollSnapshot *acqReceive(uint32_t waitMs);
+
+/**
+ * Network side: return a snapshot to the pool once it has been published.
+ */
+void acqRelease(PollSnapshot *snap);
+
+/**
+ * Network side: true when the acquisition task is waiting for the radio.
+ * Bring WiFi down, then call acqRadioGrant(). With WIFI_BLE_COEXIST the
+ * grant can be given right away and WiFi left up.
+ */
+bool acqRadioWanted();
+
+/**
+ * Network side: let the acquisition task use the radio.
+ */
+void acqRadioGrant();
+
+/**
+ * Network side: wait up to `waitMs` for the acquisition task to finish
+ * with the radio. Returns true once it is free for WiFi again.
+ */
+bool acqRadioReturned(uint32_t waitMs);
+
+/**
+ * Wait up to `waitMs` until no poll is running (mirrors included).
+ * Returns true once the acquisition task is idle.
+ */
+bool acqWaitIdle(uint32_t waitMs);
+
+/**
+ * Milliseconds until the acquisition task starts its next poll.
+ * Only meaningful while it is idle.
+ */
+uint32_t acqMsUntilNextPoll();
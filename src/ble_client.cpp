@@ -2,10 +2,17 @@
 #include "config.h"
 #include "bwt_protocol.h"
 #include "packet_collector.h"
+#include "delay_tuner.h"
+#include "gatt_cache.h"
+#include "spsc_ring.h"
 #include "utils.h"
 
 #include <Arduino.h>
 #include <NimBLEDevice.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <atomic>
+#include <string.h>
 
 // ─── NimBLE RC to string helper ─────────────────────────────
 
@@ -169,23 +176,140 @@ static uint8_t s_targetAddrType = 0;
 static int s_targetRSSI = 0;
 static bool s_targetFound = false;
 static NimBLEClient *s_client = nullptr;
-static NimBLERemoteService *s_service = nullptr;
-static NimBLERemoteCharacteristic *s_charBuffer = nullptr;    // F2E1
-static NimBLERemoteCharacteristic *s_charTrigger = nullptr;   // F2E2
-static NimBLERemoteCharacteristic *s_charBroadcast = nullptr; // F2E3
 
-// Pointer to the active collector (used by notification callback)
-static PacketCollector *s_activeCollector = nullptr;
+// Attribute handles for the current connection. GATT I/O goes through the
+// host API by handle, so a connection served from the NVS cache never
+// needs the NimBLERemote* objects that discovery would build.
+// The cache itself is kept in RTC memory, so a deep-sleep wake skips NVS.
+RTC_DATA_ATTR static GattCache s_cache{};       // peer + handles as last discovered
+RTC_DATA_ATTR static bool s_cacheValid = false; // s_cache holds a complete entry
+static bool s_handlesReady = false; // handles usable on this connection
+static bool s_handlesVerified = false; // discovered (not just cached) this connection
+
+// Raw notification frames handed from the NimBLE host task to the task
+// running bleFetchDataset(), which owns the collector. The host task only
+// copies 20 bytes and never blocks; 64 frames is >1 s of stream at 20 ms.
+struct NotifyFrame
+{
+    uint8_t len;
+    uint8_t data[PACKET_SIZE];
+};
+
+#define NOTIFY_RING_SIZE 64
+
+// A pause between frames of one response must not pass for its end
+static_assert(BLE_STREAM_QUIET_MS > 2 * CMD_DELAY_MAX, "stream quiet window too short");
+
+static SpscRing<NotifyFrame, NOTIFY_RING_SIZE> s_frames;
+static std::atomic<bool> s_framesOpen{false};       // accept frames (fetch in progress)
+static std::atomic<uint32_t> s_droppedFrames{0};    // ring full, frame lost
+static std::atomic<uint32_t> s_lastNotifyAt{0};     // millis() of the last F2E1 frame, queued or not
+static BleLinkStats s_stats{};
+
+// Signals from NimBLE host callbacks to the task waiting in this module
+#define EVT_FRAME (1 << 0)      // notification frame queued
+#define EVT_SCAN_FOUND (1 << 1) // target device matched during scan
+#define EVT_SCAN_ENDED (1 << 2) // scan window elapsed
+#define EVT_GATT_DONE (1 << 3)  // handle-based read/write completed
+static EventGroupHandle_t s_events = nullptr;
+
+// ─── Notification Listener ──────────────────────────────────
+
+// Which notifications belong to the fetch. Read by the host task on every
+// notification, and the handle can move while frames are open (handle
+// recovery), so both are atomic.
+static std::atomic<uint16_t> s_notifyConn{0};
+static std::atomic<uint16_t> s_notifyHandle{0};
+
+// Global GAP listener: sees F2E1 notifications by handle whether or not
+// the client discovered the characteristic on this connection
+static int gapEventListener(struct ble_gap_event *event, void *arg)
+{
+    if (event->type != BLE_GAP_EVENT_NOTIFY_RX ||
+        event->notify_rx.conn_handle != s_notifyConn.load(std::memory_order_relaxed) ||
+        event->notify_rx.attr_handle != s_notifyHandle.load(std::memory_order_relaxed))
+        return 0;
+
+    // Tracked even between fetches, so a trigger can tell whether the
+    // previous response is still on the air
+    s_lastNotifyAt.store(millis(), std::memory_order_relaxed);
+    if (!s_framesOpen.load(std::memory_order_acquire))
+        return 0;
+
+    NotifyFrame frame;
+    uint16_t length = os_mbuf_len(event->notify_rx.om);
+    frame.len = length < PACKET_SIZE ? (uint8_t)length : PACKET_SIZE;
+    os_mbuf_copydata(event->notify_rx.om, 0, frame.len, frame.data);
+    if (!s_frames.push(frame))
+        s_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+    xEventGroupSetBits(s_events, EVT_FRAME);
+    return 0;
+}
+
+static struct ble_gap_event_listener s_gapListener;
 
-// ─── Notification Callback ──────────────────────────────────
+// ─── Handle-Based GATT Operations ───────────────────────────
+
+// Result of the last read/write, filled in by the host task
+struct GattOpResult
+{
+    int status;
+    uint16_t len;
+    uint8_t data[32];
+};
+
+static GattOpResult s_gattOp;
+
+static int gattOpCallback(uint16_t connHandle, const struct ble_gatt_error *error,
+                          struct ble_gatt_attr *attr, void *arg)
+{
+    s_gattOp.status = error->status;
+    if (error->status == 0 && attr && attr->om)
+    {
+        uint16_t len = os_mbuf_len(attr->om);
+        s_gattOp.len = len < sizeof(s_gattOp.data) ? len : sizeof(s_gattOp.data);
+        os_mbuf_copydata(attr->om, 0, s_gattOp.len, s_gattOp.data);
+    }
+    xEventGroupSetBits(s_events, EVT_GATT_DONE);
+    return 0;
+}
 
-static void notifyCallback(NimBLERemoteCharacteristic *pChar,
-                           uint8_t *pData, size_t length, bool isNotify)
+// Wait for gattOpCallback after a request was queued with result `rc`
+static bool gattWait(int rc, const char *what, uint16_t handle)
 {
-    if (s_activeCollector)
+    if (rc == 0)
     {
-        collectorOnPacket(*s_activeCollector, pData, (uint16_t)length);
+        EventBits_t bits = xEventGroupWaitBits(s_events, EVT_GATT_DONE, pdTRUE, pdFALSE,
+                                               pdMS_TO_TICKS(BLE_GATT_OP_TIMEOUT_MS));
+        rc = (bits & EVT_GATT_DONE) ? s_gattOp.status : BLE_HS_ETIMEOUT;
     }
+    if (rc != 0)
+        Serial.printf("[BLE] GATT %s of handle 0x%04X failed — RC: %d (0x%04X) = %s\n",
+                      what, handle, rc, rc, nimbleRCtoStr(rc));
+    return rc == 0;
+}
+
+static bool gattRead(uint16_t handle)
+{
+    s_gattOp.len = 0;
+    xEventGroupClearBits(s_events, EVT_GATT_DONE);
+    int rc = ble_gattc_read(s_client->getConnId(), handle, gattOpCallback, nullptr);
+    return gattWait(rc, "read", handle);
+}
+
+static bool gattWrite(uint16_t handle, const uint8_t *data, uint16_t len)
+{
+    xEventGroupClearBits(s_events, EVT_GATT_DONE);
+    int rc = ble_gattc_write_flat(s_client->getConnId(), handle, data, len,
+                                  gattOpCallback, nullptr);
+    return gattWait(rc, "write", handle);
+}
+
+// Enable or disable F2E1 notifications through its CCCD
+static bool gattSubscribe(bool enable)
+{
+    const uint8_t value[2] = {(uint8_t)(enable ? 0x01 : 0x00), 0x00};
+    return gattWrite(s_cache.bufferCccdHandle, value, sizeof(value));
 }
 
 // ─── Scan Callback ──────────────────────────────────────────
@@ -214,6 +338,7 @@ public:
                 s_targetRSSI = advertisedDevice->getRSSI();
                 s_targetFound = true;
                 deviceFound = true;
+                xEventGroupSetBits(s_events, EVT_SCAN_FOUND);
                 NimBLEDevice::getScan()->stop();
             }
         }
@@ -234,6 +359,7 @@ public:
                 s_targetRSSI = advertisedDevice->getRSSI();
                 s_targetFound = true;
                 deviceFound = true;
+                xEventGroupSetBits(s_events, EVT_SCAN_FOUND);
                 NimBLEDevice::getScan()->stop();
             }
         }
@@ -242,14 +368,25 @@ public:
 
 static ScanCallbacks s_scanCallbacks;
 
+static void scanEndedCallback(NimBLEScanResults results)
+{
+    xEventGroupSetBits(s_events, EVT_SCAN_ENDED);
+}
+
 // ─── Public Functions ───────────────────────────────────────
 
 void bleInit()
 {
+    s_events = xEventGroupCreate();
     NimBLEDevice::init("bwt-bridge");
     // Set power to max for better range
     NimBLEDevice::setPower(ESP_PWR_LVL_P9);
+    ble_gap_event_listener_register(&s_gapListener, gapEventListener, nullptr);
+    if (!s_cacheValid)
+        s_cacheValid = gattCacheLoad(s_cache);
     Serial.println("[BLE] NimBLE initialized");
+    if (s_cacheValid)
+        Serial.printf("[BLE] Cached GATT handles for %s\n", s_cache.address);
 }
 
 bool bleScan()
@@ -264,16 +401,19 @@ bool bleScan()
     pScan->setWindow(99);
 
     Serial.println("[BLE] Starting scan...");
-    pScan->start(BLE_SCAN_DURATION_SEC, false);
-
-    // Block until scan completes or device found
-    unsigned long start = millis();
-    while (!s_scanCallbacks.deviceFound &&
-           (millis() - start) < (BLE_SCAN_DURATION_SEC * 1000 + 1000))
+    xEventGroupClearBits(s_events, EVT_SCAN_FOUND | EVT_SCAN_ENDED);
+    if (!pScan->start(BLE_SCAN_DURATION_SEC, scanEndedCallback, false))
     {
-        delay(100);
+        Serial.println("[BLE] Scan failed to start");
+        return false;
     }
 
+    // Block until the device is found or the scan window ends
+    xEventGroupWaitBits(s_events, EVT_SCAN_FOUND | EVT_SCAN_ENDED, pdTRUE, pdFALSE,
+                        pdMS_TO_TICKS(BLE_SCAN_DURATION_SEC * 1000 + 1000));
+    if (pScan->isScanning())
+        pScan->stop();
+
     pScan->clearResults();
 
     if (s_scanCallbacks.deviceFound && s_targetFound)
@@ -286,15 +426,80 @@ bool bleScan()
     return false;
 }
 
-bool bleConnect()
+const char *bleTargetAddress()
 {
+    static std::string addr;
     if (!s_targetFound)
+        return "";
+    addr = s_targetAddr.toString();
+    return addr.c_str();
+}
+
+// Full service/characteristic/descriptor discovery; refreshes the cache
+static bool discoverHandles()
+{
+    Serial.println("[BLE] Discovering services...");
+    unsigned long start = millis();
+
+    NimBLERemoteService *service = s_client->getService(BWT_SERVICE_UUID);
+    if (!service)
     {
-        Serial.println("[BLE] No target device to connect to");
+        Serial.println("[BLE] BWT service not found!");
         return false;
     }
 
-    for (int attempt = 1; attempt <= BLE_CONNECT_RETRIES; attempt++)
+    NimBLERemoteCharacteristic *charBuffer = service->getCharacteristic(BWT_CHAR_BUFFER_UUID);
+    NimBLERemoteCharacteristic *charTrigger = service->getCharacteristic(BWT_CHAR_TRIGGER_UUID);
+    NimBLERemoteCharacteristic *charBroadcast = service->getCharacteristic(BWT_CHAR_BROADCAST_UUID);
+    NimBLERemoteDescriptor *cccd = charBuffer ? charBuffer->getDescriptor(NimBLEUUID((uint16_t)0x2902)) : nullptr;
+
+    if (!charBuffer || !charTrigger || !charBroadcast || !cccd)
+    {
+        Serial.println("[BLE] Missing characteristic(s)!");
+        Serial.printf("  Buffer(F2E1): %s, CCCD: %s, Trigger(F2E2): %s, Broadcast(F2E3): %s\n",
+                      charBuffer ? "OK" : "MISSING",
+                      cccd ? "OK" : "MISSING",
+                      charTrigger ? "OK" : "MISSING",
+                      charBroadcast ? "OK" : "MISSING");
+        return false;
+    }
+
+    std::string addr = s_targetAddr.toString();
+    memset(&s_cache, 0, sizeof(s_cache));
+    strncpy(s_cache.address, addr.c_str(), sizeof(s_cache.address) - 1);
+    s_cache.addrType = s_targetAddrType;
+    s_cache.bufferHandle = charBuffer->getHandle();
+    s_cache.bufferCccdHandle = cccd->getHandle();
+    s_cache.triggerHandle = charTrigger->getHandle();
+    s_cache.broadcastHandle = charBroadcast->getHandle();
+    s_cacheValid = true;
+    s_handlesReady = true;
+    s_handlesVerified = true;
+    gattCacheSave(s_cache);
+
+    Serial.printf("[BLE] Service and characteristics discovered in %lu ms\n",
+                  millis() - start);
+    return true;
+}
+
+// Called when an operation on a cached handle failed while still
+// connected: the peer's GATT table may have changed (firmware update), so
+// drop the cache and rediscover once. Returns true if the caller should retry.
+static bool recoverHandles()
+{
+    if (s_handlesVerified || !bleIsConnected())
+        return false;
+    Serial.println("[BLE] Cached handles rejected, falling back to discovery");
+    gattCacheClear();
+    s_cacheValid = false;
+    s_handlesReady = false;
+    return discoverHandles();
+}
+
+// Connect to s_targetAddr, up to `attempts` tries of `timeoutMs` each
+static bool connectTarget(int attempts, uint32_t timeoutMs)
+{
+    for (int attempt = 1; attempt <= attempts; attempt++)
     {
         // Create or reuse client
         if (s_client)
@@ -309,14 +514,14 @@ bool bleConnect()
 
         s_client = NimBLEDevice::createClient();
         s_client->setClientCallbacks(&s_clientCallbacks, false);
-        s_client->setConnectTimeout(BLE_CONNECT_TIMEOUT_MS / 1000); // NimBLE uses seconds
+        s_client->setConnectTimeout(timeoutMs / 1000); // NimBLE uses seconds
 
         Serial.printf("[BLE] Connecting to %s (addrType: %s, RSSI: %d, timeout: %ds, attempt %d/%d)...\n",
                       s_targetAddr.toString().c_str(),
                       addrTypeToStr(s_targetAddrType),
                       s_targetRSSI,
-                      BLE_CONNECT_TIMEOUT_MS / 1000,
-                      attempt, BLE_CONNECT_RETRIES);
+                      (int)(timeoutMs / 1000),
+                      attempt, attempts);
         Serial.printf("[BLE] NimBLE client count: %d, free heap: %u\n",
                       NimBLEDevice::getClientListSize(), ESP.getFreeHeap());
 
@@ -325,7 +530,7 @@ bool bleConnect()
             int lastErr = s_client->getLastError();
             Serial.printf("[BLE] Connection attempt %d FAILED — RC: %d (0x%04X) = %s\n",
                           attempt, lastErr, lastErr, nimbleRCtoStr(lastErr));
-            if (attempt < BLE_CONNECT_RETRIES)
+            if (attempt < attempts)
             {
                 uint32_t backoff = attempt * BLE_CONNECT_RETRY_DELAY_MS;
                 Serial.printf("[BLE] Retrying in %lu ms...\n", (unsigned long)backoff);
@@ -334,48 +539,82 @@ bool bleConnect()
             continue;
         }
 
-        Serial.println("[BLE] Connected, discovering services...");
-
-        // Discover the BWT service
-        s_service = s_client->getService(BWT_SERVICE_UUID);
-        if (!s_service)
+        // The handles are only trusted for the peer they were discovered on;
+        // if one turns out stale, recoverHandles() rediscovers
+        s_handlesVerified = false;
+        s_handlesReady = s_cacheValid &&
+                         strcasecmp(s_cache.address, s_targetAddr.toString().c_str()) == 0;
+        if (s_handlesReady)
+        {
+            Serial.println("[BLE] Connected, using cached GATT handles");
+        }
+        else if (!discoverHandles())
         {
-            Serial.println("[BLE] BWT service not found!");
             s_client->disconnect();
             return false;
         }
 
-        // Get characteristics
-        s_charBuffer = s_service->getCharacteristic(BWT_CHAR_BUFFER_UUID);
-        s_charTrigger = s_service->getCharacteristic(BWT_CHAR_TRIGGER_UUID);
-        s_charBroadcast = s_service->getCharacteristic(BWT_CHAR_BROADCAST_UUID);
+        tunerLoad(s_targetAddr.toString().c_str());
+        return true;
+    }
+
+    Serial.printf("[BLE] All %d connection attempts failed\n", attempts);
+    return false;
+}
+
+bool bleConnect()
+{
+    if (!s_targetFound)
+    {
+        Serial.println("[BLE] No target device to connect to");
+        return false;
+    }
+    return connectTarget(BLE_CONNECT_RETRIES, BLE_CONNECT_TIMEOUT_MS);
+}
 
-        if (!s_charBuffer || !s_charTrigger || !s_charBroadcast)
+bool bleConnectDirect()
+{
+    // Prefer the device seen last cycle, then the cached peer, then the
+    // configured MAC (assumed public until a scan reports otherwise)
+    if (!s_targetFound)
+    {
+        String macFilter(BWT_DEVICE_MAC);
+        if (s_cacheValid &&
+            (macFilter.length() == 0 || macFilter.equalsIgnoreCase(s_cache.address)))
         {
-            Serial.println("[BLE] Missing characteristic(s)!");
-            Serial.printf("  Buffer(F2E1): %s, Trigger(F2E2): %s, Broadcast(F2E3): %s\n",
-                          s_charBuffer ? "OK" : "MISSING",
-                          s_charTrigger ? "OK" : "MISSING",
-                          s_charBroadcast ? "OK" : "MISSING");
-            s_client->disconnect();
-            return false;
+            s_targetAddr = NimBLEAddress(std::string(s_cache.address), s_cache.addrType);
+            s_targetAddrType = s_cache.addrType;
         }
+        else if (macFilter.length() > 0)
+        {
+            s_targetAddr = NimBLEAddress(std::string(macFilter.c_str()), BLE_ADDR_PUBLIC);
+            s_targetAddrType = BLE_ADDR_PUBLIC;
+        }
+        else
+        {
+            return false; // nothing known yet, scan
+        }
+        s_targetRSSI = 0;
+    }
 
-        Serial.println("[BLE] Service and characteristics discovered");
+    Serial.printf("[BLE] Direct connect to known address %s\n",
+                  s_targetAddr.toString().c_str());
+    if (connectTarget(1, BLE_DIRECT_CONNECT_TIMEOUT_MS))
+    {
+        s_targetFound = true;
         return true;
     }
 
-    Serial.printf("[BLE] All %d connection attempts failed\n", BLE_CONNECT_RETRIES);
+    // Rescan next time: the device may have a new address or be out of range
+    s_targetFound = false;
+    bleDisconnect();
     return false;
 }
 
 void bleDisconnect()
 {
-    s_activeCollector = nullptr;
-    s_charBuffer = nullptr;
-    s_charTrigger = nullptr;
-    s_charBroadcast = nullptr;
-    s_service = nullptr;
+    s_framesOpen.store(false, std::memory_order_release);
+    s_handlesReady = false;
 
     if (s_client && s_client->isConnected())
     {
@@ -391,21 +630,24 @@ bool bleIsConnected()
 
 bool bleReadBroadcast(BroadcastState &state)
 {
-    if (!s_charBroadcast)
+    if (!s_handlesReady)
     {
         Serial.println("[BLE] Broadcast characteristic not available");
         return false;
     }
 
-    NimBLEAttValue val = s_charBroadcast->readValue();
-    if (val.length() < 15)
+    // First operation after connecting, so it also validates cached handles
+    bool read = gattRead(s_cache.broadcastHandle) && s_gattOp.len >= 15;
+    if (!read && recoverHandles())
+        read = gattRead(s_cache.broadcastHandle) && s_gattOp.len >= 15;
+    if (!read)
     {
         Serial.printf("[BLE] Broadcast read returned %u bytes (expected 15)\n",
-                      val.length());
+                      s_gattOp.len);
         return false;
     }
 
-    bool ok = parseBroadcast(val.data(), val.length(), state);
+    bool ok = parseBroadcast(s_gattOp.data, s_gattOp.len, state);
     if (ok)
     {
         Serial.printf("[BLE] Broadcast: remaining=%lu, QH_idx=%u, days_idx=%u, "
@@ -419,9 +661,105 @@ bool bleReadBroadcast(BroadcastState &state)
     return ok;
 }
 
+// Wait until no notification has arrived for BLE_STREAM_QUIET_MS.
+// Frames carry only an index relative to their own request, so a late
+// frame of the previous response would be mapped onto the next range.
+// Returns false if the device is still sending after BLE_PACKET_STALL_MS.
+static bool waitForQuiet()
+{
+    unsigned long start = millis();
+    for (;;)
+    {
+        unsigned long now = millis();
+        long quietFor = (long)(now - s_lastNotifyAt.load(std::memory_order_relaxed));
+        if (quietFor >= BLE_STREAM_QUIET_MS)
+            return true;
+        if (now - start >= BLE_PACKET_STALL_MS)
+            return false;
+        delay(BLE_STREAM_QUIET_MS - quietFor);
+    }
+}
+
+// Write a buffer-read trigger for [address, address + size) to F2E2
+static bool writeTrigger(uint16_t address, uint16_t size, uint16_t packets,
+                         uint16_t delayMs)
+{
+    if (!waitForQuiet())
+    {
+        Serial.println("[BLE] Previous response still streaming, not re-triggering");
+        return false;
+    }
+
+    uint8_t cmd[7];
+    buildTriggerCommand(address, size, delayMs, cmd);
+    Serial.printf("[BLE] Trigger: addr=0x%04X, size=%u, delay=%u ms, expected %u packets\n",
+                  address, size, delayMs, packets);
+    // The previous response has gone quiet; whatever is still queued from
+    // it is dropped before this one can answer
+    s_frames.clear();
+    xEventGroupClearBits(s_events, EVT_FRAME);
+    if (gattWrite(s_cache.triggerHandle, cmd, 7))
+        return true;
+    if (!recoverHandles())
+        return false;
+    // Rediscovered handles may move F2E1 too; follow it before retrying
+    s_notifyHandle.store(s_cache.bufferHandle, std::memory_order_relaxed);
+    return gattSubscribe(true) && gattWrite(s_cache.triggerHandle, cmd, 7);
+}
+
+// Feed queued notification frames to the collector (consumer side)
+static void drainFrames(PacketCollector &collector)
+{
+    NotifyFrame frame;
+    while (s_frames.pop(frame))
+        collectorOnPacket(collector, frame.data, frame.len);
+}
+
+// Block until the current request's packets are all in, errors out,
+// stalls for BLE_PACKET_STALL_MS, or the overall fetch deadline passes.
+// Once the final index has arrived only a short grace period is left for
+// reordered stragglers before the gaps are re-requested.
+// Sleeps on the event group and wakes for every queued frame, so it
+// returns as soon as the last packet lands; timeouts only re-check the
+// stall deadline.
+// Returns false only when the overall deadline has passed.
+static bool waitForStream(PacketCollector &collector, unsigned long fetchStart)
+{
+    for (;;)
+    {
+        drainFrames(collector);
+        if (collector.streamDone || collector.complete || collector.error)
+            break;
+
+        unsigned long now = millis();
+        if ((now - fetchStart) >= BLE_PACKET_TIMEOUT_MS)
+            return false;
+
+        bool tail = collector.tailSeen;
+        unsigned long deadline = collector.lastPacketAt +
+                                 (tail ? BLE_REORDER_GRACE_MS : BLE_PACKET_STALL_MS);
+        long remaining = (long)(deadline - now);
+        long overall = (long)(fetchStart + BLE_PACKET_TIMEOUT_MS - now);
+        if (overall < remaining)
+            remaining = overall;
+
+        if (remaining <= 0)
+        {
+            Serial.printf("[BLE] Stream %s with %u/%u packets of this request\n",
+                          tail ? "ended" : "stalled",
+                          collector.rangeReceived, collector.rangeCount);
+            break;
+        }
+
+        xEventGroupWaitBits(s_events, EVT_FRAME, pdTRUE, pdFALSE,
+                            pdMS_TO_TICKS(remaining) + 1);
+    }
+    return true;
+}
+
 bool bleFetchDataset(uint16_t address, uint16_t size, PacketCollector &collector)
 {
-    if (!s_charBuffer || !s_charTrigger)
+    if (!s_handlesReady)
     {
         Serial.println("[BLE] Characteristics not available for fetch");
         return false;
@@ -433,42 +771,94 @@ bool bleFetchDataset(uint16_t address, uint16_t size, PacketCollector &collector
         return false;
     }
 
-    // Point the notification callback at this collector
-    s_activeCollector = &collector;
+    // Start queueing notification frames for this fetch
+    s_frames.clear();
+    s_droppedFrames.store(0, std::memory_order_relaxed);
+    s_notifyConn.store(s_client->getConnId(), std::memory_order_relaxed);
+    s_notifyHandle.store(s_cache.bufferHandle, std::memory_order_relaxed);
+    s_framesOpen.store(true, std::memory_order_release);
 
     // Subscribe to notifications on F2E1
-    if (!s_charBuffer->subscribe(true, notifyCallback))
+    bool subscribed = gattSubscribe(true);
+    if (!subscribed && recoverHandles())
+    {
+        s_notifyHandle.store(s_cache.bufferHandle, std::memory_order_relaxed);
+        subscribed = gattSubscribe(true);
+    }
+    if (!subscribed)
     {
         Serial.println("[BLE] Failed to subscribe to F2E1 notifications");
-        s_activeCollector = nullptr;
+        s_framesOpen.store(false, std::memory_order_release);
         return false;
     }
 
-    // Build and write trigger command
-    uint8_t cmd[7];
-    buildTriggerCommand(address, size, cmd);
-    Serial.printf("[BLE] Trigger: addr=0x%04X, size=%u, expected %u packets\n",
-                  address, size, collector.expectedPackets);
-
-    if (!s_charTrigger->writeValue(cmd, 7, true))
+    unsigned long start = millis();
+    if (!writeTrigger(address, size, collector.expectedPackets, tunerDelay()))
     {
         Serial.println("[BLE] Failed to write trigger command");
-        s_charBuffer->unsubscribe();
-        s_activeCollector = nullptr;
+        gattSubscribe(false);
+        s_framesOpen.store(false, std::memory_order_release);
         return false;
     }
+    // After the write: waitForQuiet() must not eat into the stall window.
+    // Frames only reach the collector in waitForStream(), so none is missed.
+    collectorBeginRange(collector, 0, collector.expectedPackets);
+    bool inTime = waitForStream(collector, start);
+    if (!collector.error)
+    {
+        tunerReport(collector.expectedPackets, collectorMissingCount(collector));
+        s_stats.requested += collector.expectedPackets;
+        s_stats.firstPassLost += collectorMissingCount(collector);
+    }
 
-    // Wait for collection to complete or timeout
-    unsigned long start = millis();
-    while (!collector.complete && !collector.error &&
-           (millis() - start) < BLE_PACKET_TIMEOUT_MS)
+    // Re-request only the packets that never arrived. Each follow-up
+    // covers one contiguous run, aligned to packet boundaries.
+    uint16_t retransmitted = 0;
+    if (!collector.complete && !collector.error)
     {
-        delay(10);
+        uint16_t missing[8];
+        uint16_t shown = collectorMissing(collector, missing, 8);
+        Serial.printf("[BLE] %u packet(s) missing:", collectorMissingCount(collector));
+        for (uint16_t i = 0; i < shown; i++)
+            Serial.printf(" %u", missing[i]);
+        Serial.println(shown < collectorMissingCount(collector) ? " ..." : "");
+    }
+    for (uint8_t round = 0; round < BLE_RETRANSMIT_ROUNDS && inTime &&
+                            !collector.complete && !collector.error && bleIsConnected();
+         round++)
+    {
+        uint16_t from = 0, first, count;
+        while (inTime && !collector.error &&
+               collectorNextGap(collector, from, first, count))
+        {
+            uint16_t offset = first * PACKET_DATA;
+            uint16_t len = min((uint32_t)count * PACKET_DATA,
+                               (uint32_t)(collector.expectedBytes - offset));
+            Serial.printf("[BLE] Retransmit round %u: packets %u..%u\n",
+                          round + 1, first, first + count - 1);
+
+            if (!writeTrigger(address + offset, len, count, tunerStableDelay()))
+            {
+                Serial.println("[BLE] Failed to write retransmit trigger");
+                break;
+            }
+            collectorBeginRange(collector, first, count);
+            inTime = waitForStream(collector, start);
+            retransmitted += count;
+            from = first + count;
+        }
     }
 
     // Unsubscribe
-    s_charBuffer->unsubscribe();
-    s_activeCollector = nullptr;
+    s_framesOpen.store(false, std::memory_order_release);
+    gattSubscribe(false);
+    uint32_t dropped = s_droppedFrames.load(std::memory_order_relaxed);
+    s_stats.droppedFrames += dropped;
+    s_stats.retransmitted += retransmitted;
+    if (!collector.error)
+        s_stats.unrecovered += collectorMissingCount(collector);
+    if (dropped > 0)
+        Serial.printf("[BLE] %lu frame(s) dropped (notify ring full)\n", (unsigned long)dropped);
 
     if (collector.error)
     {
@@ -478,12 +868,24 @@ bool bleFetchDataset(uint16_t address, uint16_t size, PacketCollector &collector
 
     if (!collector.complete)
     {
-        Serial.printf("[BLE] Timeout: received %u/%u packets\n",
+        Serial.printf("[BLE] %s: received %u/%u packets\n",
+                      inTime ? "Incomplete" : "Timeout",
                       collector.receivedPackets, collector.expectedPackets);
         return false;
     }
 
-    Serial.printf("[BLE] Dataset fetched: %u bytes in %u packets\n",
-                  collector.bufferLen, collector.receivedPackets);
+    Serial.printf("[BLE] Dataset fetched: %u bytes in %u packets (%u missed, %u reordered, %u re-requested)\n",
+                  collector.bufferLen, collector.receivedPackets,
+                  collector.missedPackets, collector.reorderedPackets, retransmitted);
     return true;
 }
+
+void bleResetStats()
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+BleLinkStats bleStats()
+{
+    return s_stats;
+}
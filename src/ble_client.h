@@ -4,6 +4,19 @@
 #include "packet_collector.h"
 #include <stdint.h>
 
+/**
+ * Link quality counters accumulated by bleFetchDataset() since the last
+ * bleResetStats().
+ */
+struct BleLinkStats
+{
+    uint32_t requested;     // packets requested by first passes
+    uint32_t firstPassLost; // of those, missing when the first pass ended
+    uint32_t retransmitted; // packets re-requested
+    uint32_t unrecovered;   // still missing after every retransmit round
+    uint32_t droppedFrames; // notifications lost to a full notify ring
+};
+
 /**
  * Initialize NimBLE stack. Call once in setup().
  */
@@ -14,13 +27,29 @@ void bleInit();
  */
 bool bleScan();
 
+/**
+ * MAC address of the device found by the last scan ("aa:bb:cc:dd:ee:ff"),
+ * or an empty string if no device has been found yet.
+ */
+const char *bleTargetAddress();
+
 /**
  * Connect to the BWT device found during scan.
- * Requests MTU 512, discovers service and characteristics.
+ * Attribute handles cached in NVS for this peer are used as-is; service
+ * and characteristic discovery only runs for a new peer, or when a cached
+ * handle is rejected later in the session.
  * Returns true on success.
  */
 bool bleConnect();
 
+/**
+ * Connect without scanning to the device seen last cycle, the peer cached
+ * in NVS, or BWT_DEVICE_MAC, in that order. Makes a single attempt with
+ * BLE_DIRECT_CONNECT_TIMEOUT_MS. Returns false if no address is known or
+ * the attempt failed; the caller should then fall back to bleScan().
+ */
+bool bleConnectDirect();
+
 /**
  * Disconnect from the BWT device.
  */
@@ -47,3 +76,13 @@ bool bleReadBroadcast(BroadcastState &state);
  * Returns true if collection completed successfully.
  */
 bool bleFetchDataset(uint16_t address, uint16_t size, PacketCollector &collector);
+
+/**
+ * Clear the link counters, e.g. at the start of a poll.
+ */
+void bleResetStats();
+
+/**
+ * Link counters since the last bleResetStats().
+ */
+BleLinkStats bleStats();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdint.h>
+#include "bwt_regions.h"
 
 // ─── Data Structures ────────────────────────────────────────
 
@@ -18,13 +19,6 @@ struct BroadcastState
     uint8_t versionB;
 };
 
-struct ConsumptionEntry
-{
-    uint16_t litres;
-    bool powerCut;
-    uint8_t regen; // QH: 0-1, daily: 0-3
-};
-
 // ─── Functions ──────────────────────────────────────────────
 
 /**
@@ -35,28 +29,8 @@ bool parseBroadcast(const uint8_t *data, uint8_t len, BroadcastState &state);
 
 /**
  * Build a 7-byte trigger command for writing to F2E2.
+ * delayMs sets the device's inter-packet delay (the app always uses 20).
  * cmd must point to a buffer of at least 7 bytes.
  */
-void buildTriggerCommand(uint16_t address, uint16_t size, uint8_t *cmd);
-
-/**
- * Calculate the request size for a ring buffer region.
- */
-uint16_t calculateRequestSize(uint16_t idx, bool looped, uint16_t regionSize);
-
-/**
- * Parse a quarter-hour word (XR parser).
- */
-ConsumptionEntry parseQuarterHour(uint16_t word);
+void buildTriggerCommand(uint16_t address, uint16_t size, uint16_t delayMs, uint8_t *cmd);
 
-/**
- * Parse a daily word (ZR parser).
- */
-ConsumptionEntry parseDaily(uint16_t word);
-
-/**
- * Parse a raw byte buffer into consumption entries using the given parser.
- * Returns number of entries parsed. Caller must allocate `entries` with enough space.
- */
-uint16_t parseBuffer(const uint8_t *buffer, uint16_t bufferLen,
-                     ConsumptionEntry *entries, bool isDaily);
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+// ─── Region Traits ──────────────────────────────────────────
+// Everything that differs between the two device rings, as compile-time
+// constants: where the ring lives, how fast it advances and how a word is
+// laid out. Code templated on these has no runtime QH/daily branch.
+
+struct ConsumptionEntry
+{
+    uint16_t litres;
+    bool powerCut;
+    uint8_t regen; // QH: 0-1, daily: 0-3
+};
+
+struct QhRegion
+{
+    static constexpr uint16_t startAddr = QH_START_ADDR;
+    static constexpr uint16_t endAddr = QH_END_ADDR;
+    static constexpr uint32_t slotMs = 15UL * 60 * 1000;
+    static constexpr uint16_t entriesPerDay = 96;
+
+    // Word layout (XR parser)
+    static constexpr uint16_t litresMask = 0x3FF; // bits 0-9: 0–1023 litres
+    static constexpr uint16_t litresScale = 1;
+    static constexpr uint8_t powerCutBit = 10;
+    static constexpr uint8_t regenShift = 11; // bit 11: 0–1
+    static constexpr uint8_t regenMask = 1;
+
+    static constexpr uint16_t bytes = endAddr - startAddr;
+    static constexpr uint16_t words = bytes / 2;
+};
+
+struct DailyRegion
+{
+    static constexpr uint16_t startAddr = DAILY_START_ADDR;
+    static constexpr uint16_t endAddr = DAILY_END_ADDR;
+    static constexpr uint32_t slotMs = 24UL * 60 * 60 * 1000;
+    static constexpr uint16_t entriesPerDay = 1;
+
+    // Word layout (ZR parser)
+    static constexpr uint16_t litresMask = 0x7FF; // bits 0-10 × 10: 0–20470 litres
+    static constexpr uint16_t litresScale = 10;
+    static constexpr uint8_t powerCutBit = 11;
+    static constexpr uint8_t regenShift = 12; // bits 12-13: 0–3
+    static constexpr uint8_t regenMask = 3;
+
+    static constexpr uint16_t bytes = endAddr - startAddr;
+    static constexpr uint16_t words = bytes / 2;
+};
+
+/**
+ * A ring word as the device stores it (after big-endian load), decoded on
+ * access. Two bytes, so history can stay in the raw ring buffer.
+ */
+template <typename R>
+struct RegionWord
+{
+    uint16_t raw;
+    constexpr uint16_t litres() const { return R::litresScale * (raw & R::litresMask); }
+    constexpr bool powerCut() const { return (raw & (1u << R::powerCutBit)) != 0; }
+    constexpr uint8_t regen() const { return (raw >> R::regenShift) & R::regenMask; }
+    constexpr ConsumptionEntry entry() const { return {litres(), powerCut(), regen()}; }
+};
+
+using QhWord = RegionWord<QhRegion>;
+using DailyWord = RegionWord<DailyRegion>;
+
+// ─── Compile-Time Checks ────────────────────────────────────
+
+template <typename R>
+constexpr bool regionLayoutValid()
+{
+    return R::endAddr > R::startAddr &&
+           R::bytes % 2 == 0 &&
+           R::slotMs * R::entriesPerDay == 24UL * 60 * 60 * 1000 &&
+           R::litresMask < (1u << R::powerCutBit) &&
+           R::powerCutBit < R::regenShift &&
+           (R::regenMask << R::regenShift) <= 0xFFFF &&
+           (uint32_t)R::litresScale * R::litresMask <= 0xFFFF;
+}
+
+static_assert(regionLayoutValid<QhRegion>(), "QH region traits are inconsistent");
+static_assert(regionLayoutValid<DailyRegion>(), "daily region traits are inconsistent");
+static_assert(QhRegion::endAddr <= DailyRegion::startAddr, "QH and daily regions overlap");
+static_assert(QhRegion::words % QhRegion::entriesPerDay == 0, "QH ring must hold whole days");
+static_assert(sizeof(QhWord) == 2 && sizeof(DailyWord) == 2, "ring words must stay packed");
+static_assert(QhWord{0x0C2A}.litres() == 42 && QhWord{0x0C2A}.regen() == 1, "QH word layout");
+static_assert(DailyWord{0x2805}.litres() == 50 && DailyWord{0x2805}.regen() == 2, "daily word layout");
@@ -0,0 +1,149 @@
+#include "delay_tuner.h"
+#include "config.h"
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <ctype.h>
+#include <string.h>
+
+// Packets pooled before a window is judged; a steady-state delta fetch is
+// only a few packets, so single requests are too noisy on their own
+#define TUNER_WINDOW_PACKETS 60
+// Clean windows in a row before probing a shorter delay
+#define TUNER_PROBE_AFTER 2
+// Clean windows at the stable delay before a failed delay may be retried
+#define TUNER_FLOOR_EXPIRY 20
+
+// ─── Module State ───────────────────────────────────────────
+// RTC memory: tuning continues across deep sleep without an NVS read
+
+RTC_DATA_ATTR static char s_key[13] = "";          // NVS key: MAC without separators
+RTC_DATA_ATTR static uint16_t s_delay = CMD_DELAY;  // delay for the next request
+RTC_DATA_ATTR static uint16_t s_stable = CMD_DELAY; // last delay with a clean window
+RTC_DATA_ATTR static uint16_t s_floor = 0;          // highest delay seen failing (0 = none)
+RTC_DATA_ATTR static uint16_t s_windowPackets = 0;
+RTC_DATA_ATTR static uint16_t s_windowLost = 0;
+RTC_DATA_ATTR static uint8_t s_cleanStreak = 0;
+RTC_DATA_ATTR static uint8_t s_floorAge = 0;
+
+// ─── Helpers ────────────────────────────────────────────────
+
+static void saveStable()
+{
+    if (s_key[0] == '\0')
+        return;
+    Preferences prefs;
+    if (!prefs.begin("bwt-tuner", false))
+        return;
+    prefs.putUShort(s_key, s_stable);
+    prefs.end();
+    Serial.printf("[Tuner] Stored stable delay %u ms for %s\n", s_stable, s_key);
+}
+
+// ─── Public Functions ───────────────────────────────────────
+
+void tunerLoad(const char *deviceAddr)
+{
+    char key[13];
+    size_t n = 0;
+    for (const char *p = deviceAddr; *p && n + 1 < sizeof(key); p++)
+    {
+        if (isxdigit((unsigned char)*p))
+            key[n++] = toupper((unsigned char)*p);
+    }
+    key[n] = '\0';
+    if (strcmp(key, s_key) == 0)
+        return;
+    strcpy(s_key, key);
+
+    s_stable = CMD_DELAY;
+    Preferences prefs;
+    if (s_key[0] != '\0' && prefs.begin("bwt-tuner", true))
+    {
+        s_stable = prefs.getUShort(s_key, CMD_DELAY);
+        prefs.end();
+    }
+    s_stable = constrain(s_stable, CMD_DELAY_MIN, CMD_DELAY_MAX);
+    s_delay = s_stable;
+    s_floor = 0;
+    s_windowPackets = 0;
+    s_windowLost = 0;
+    s_cleanStreak = 0;
+    s_floorAge = 0;
+
+    if (CMD_DELAY_ADAPTIVE)
+        Serial.printf("[Tuner] %s: starting at %u ms\n", s_key, s_delay);
+}
+
+uint16_t tunerDelay()
+{
+    return CMD_DELAY_ADAPTIVE ? s_delay : CMD_DELAY;
+}
+
+uint16_t tunerStableDelay()
+{
+    return CMD_DELAY_ADAPTIVE ? s_stable : CMD_DELAY;
+}
+
+void tunerReport(uint16_t packets, uint16_t lost)
+{
+    if (!CMD_DELAY_ADAPTIVE || packets == 0)
+        return;
+
+    s_windowPackets += packets;
+    s_windowLost += lost;
+    if (s_windowPackets < TUNER_WINDOW_PACKETS)
+        return;
+
+    uint32_t lossPct100 = (uint32_t)s_windowLost * 10000 / s_windowPackets;
+    Serial.printf("[Tuner] %u ms: %u/%u packets lost (%lu.%02lu%%)\n",
+                  s_delay, s_windowLost, s_windowPackets,
+                  (unsigned long)(lossPct100 / 100), (unsigned long)(lossPct100 % 100));
+    s_windowPackets = 0;
+    s_windowLost = 0;
+
+    if (lossPct100 > CMD_DELAY_MAX_LOSS_PCT * 100)
+    {
+        // Back off: return to the last clean delay, or widen past it
+        if (s_delay > s_floor)
+            s_floor = s_delay;
+        s_delay = s_stable > s_delay ? s_stable : s_delay + CMD_DELAY_STEP;
+        if (s_delay > CMD_DELAY_MAX)
+            s_delay = CMD_DELAY_MAX;
+        if (s_stable < s_delay)
+        {
+            // The delay we thought was stable failed too
+            s_stable = s_delay;
+            saveStable();
+        }
+        s_cleanStreak = 0;
+        s_floorAge = 0;
+        Serial.printf("[Tuner] Backing off to %u ms (failed at %u ms)\n", s_delay, s_floor);
+        return;
+    }
+
+    // Clean window: this delay is stable
+    if (s_stable != s_delay)
+    {
+        s_stable = s_delay;
+        saveStable();
+    }
+
+    if (s_floor != 0 && ++s_floorAge >= TUNER_FLOOR_EXPIRY)
+    {
+        // Link conditions change; allow another attempt below
+        s_floor = 0;
+        s_floorAge = 0;
+    }
+
+    if (++s_cleanStreak >= TUNER_PROBE_AFTER)
+    {
+        s_cleanStreak = 0;
+        uint16_t next = s_delay >= CMD_DELAY_MIN + CMD_DELAY_STEP ? s_delay - CMD_DELAY_STEP : CMD_DELAY_MIN;
+        if (next < s_delay && next > s_floor)
+        {
+            s_delay = next;
+            Serial.printf("[Tuner] Probing %u ms\n", s_delay);
+        }
+    }
+}
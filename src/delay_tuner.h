@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Select the device whose tuned delay is used and load it from NVS.
+ * No-op if `deviceAddr` is already selected.
+ */
+void tunerLoad(const char *deviceAddr);
+
+/**
+ * Inter-packet delay (ms) to put in the next trigger command.
+ * Returns CMD_DELAY when adaptive mode is disabled.
+ */
+uint16_t tunerDelay();
+
+/**
+ * Delay (ms) last confirmed loss-free, for follow-up requests that should
+ * not risk another loss.
+ */
+uint16_t tunerStableDelay();
+
+/**
+ * Report the first pass of a request sent at tunerDelay(): packets
+ * requested and packets still missing when the stream ended.
+ * Results are pooled until there are enough packets to judge the link,
+ * then the delay is stepped down on a clean window or backed off on loss.
+ * A new stable delay is persisted per device.
+ */
+void tunerReport(uint16_t packets, uint16_t lost);
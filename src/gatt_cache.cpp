@@ -0,0 +1,66 @@
+#include "gatt_cache.h"
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <string.h>
+
+// Bump when GattCache changes so old blobs are ignored
+#define GATT_CACHE_VERSION 1
+
+struct StoredCache
+{
+    uint8_t version;
+    GattCache cache;
+};
+
+// ─── Public Functions ───────────────────────────────────────
+
+bool gattCacheLoad(GattCache &cache)
+{
+    Preferences prefs;
+    if (!prefs.begin("bwt-gatt", true))
+        return false;
+
+    StoredCache stored;
+    size_t len = prefs.getBytes("peer", &stored, sizeof(stored));
+    prefs.end();
+
+    if (len != sizeof(stored) || stored.version != GATT_CACHE_VERSION ||
+        stored.cache.bufferHandle == 0 || stored.cache.bufferCccdHandle == 0 ||
+        stored.cache.triggerHandle == 0 || stored.cache.broadcastHandle == 0)
+        return false;
+
+    stored.cache.address[sizeof(stored.cache.address) - 1] = '\0';
+    cache = stored.cache;
+    return true;
+}
+
+void gattCacheSave(const GattCache &cache)
+{
+    GattCache current;
+    if (gattCacheLoad(current) && memcmp(&current, &cache, sizeof(cache)) == 0)
+        return;
+
+    StoredCache stored;
+    memset(&stored, 0, sizeof(stored));
+    stored.version = GATT_CACHE_VERSION;
+    stored.cache = cache;
+
+    Preferences prefs;
+    if (!prefs.begin("bwt-gatt", false))
+        return;
+    prefs.putBytes("peer", &stored, sizeof(stored));
+    prefs.end();
+    Serial.printf("[GATT] Cached handles for %s: F2E1=0x%04X (CCCD 0x%04X), F2E2=0x%04X, F2E3=0x%04X\n",
+                  cache.address, cache.bufferHandle, cache.bufferCccdHandle,
+                  cache.triggerHandle, cache.broadcastHandle);
+}
+
+void gattCacheClear()
+{
+    Preferences prefs;
+    if (!prefs.begin("bwt-gatt", false))
+        return;
+    prefs.remove("peer");
+    prefs.end();
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Peer identity and attribute handles remembered between connections.
+ * The BWT firmware's GATT table is fixed, so once discovered the handles
+ * stay valid and reconnects can skip service/characteristic discovery.
+ */
+struct GattCache
+{
+    char address[18];          // peer MAC "aa:bb:cc:dd:ee:ff"
+    uint8_t addrType;          // BLE_ADDR_PUBLIC / BLE_ADDR_RANDOM
+    uint16_t bufferHandle;     // F2E1 value (notify)
+    uint16_t bufferCccdHandle; // F2E1 client characteristic configuration
+    uint16_t triggerHandle;    // F2E2 value (write)
+    uint16_t broadcastHandle;  // F2E3 value (read)
+};
+
+/**
+ * Load the cached peer from NVS.
+ * Returns false if nothing is cached or the entry is from another layout.
+ */
+bool gattCacheLoad(GattCache &cache);
+
+/**
+ * Store `cache` in NVS. Skips the flash write if it is unchanged.
+ */
+void gattCacheSave(const GattCache &cache);
+
+/**
+ * Forget the cached peer, e.g. after its handles turned out to be stale.
+ */
+void gattCacheClear();
@@ -9,53 +9,94 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
+#include <esp_sleep.h>
 #include <time.h>
 
 #include "config.h"
 #include "bwt_protocol.h"
-#include "packet_collector.h"
 #include "ble_client.h"
 #include "mqtt_publisher.h"
-#include "utils.h"
+#include "ring_mirror.h"
+#include "ring_view.h"
+#include "qh_index.h"
+#include "poll_arena.h"
+#include "acquisition.h"
+#include "wifi_link.h"
+#include "time_sync.h"
 
 // ─── State Machine ──────────────────────────────────────────
+// loop() is the network task: WiFi, MQTT, decoding and publishing.
+// BLE polling runs in the acquisition task (see acquisition.h) and hands
+// over one PollSnapshot per cycle.
+// Every state is a short, re-entrant step: anything that takes time is
+// started once and then polled against s_stateTimer, so mqttLoop() keeps
+// running and no pass through loop() blocks for long.
 
 enum FirmwareState
 {
   STATE_WIFI_CONNECT,
+  STATE_WIFI_WAIT,
+  STATE_TIME_SYNC,
   STATE_MQTT_CONNECT,
   STATE_IDLE,
-  STATE_BLE_SCAN,
-  STATE_BLE_CONNECT,
-  STATE_READ_BROADCAST,
-  STATE_FETCH_QH,
-  STATE_BLE_DISCONNECT,
+  STATE_RADIO_LENT,
   STATE_MQTT_PUBLISH,
+  STATE_RETRY_WAIT,
 };
 
 static FirmwareState s_state = STATE_WIFI_CONNECT;
-static unsigned long s_lastPoll = 0;
-static unsigned long s_stateTimer = 0;
+static unsigned long s_stateTimer = 0; // millis() the current state was entered
 static uint8_t s_retryCount = 0;
-static bool s_haDiscoverySent = false;
+RTC_DATA_ATTR static bool s_haDiscoverySent = false; // RTC: not resent after deep sleep
+
+// STATE_RETRY_WAIT: state to go back to, and when
+static FirmwareState s_retryState = STATE_WIFI_CONNECT;
+static uint32_t s_retryDelayMs = 0;
+
+static bool s_radioGranted = false;        // STATE_RADIO_LENT: BLE has the radio
+static unsigned long s_reconnectStart = 0; // restoring the network after BLE (0 = no)
+static bool s_sleepPending = false;        // deep sleep once the acquisition task is idle
+
+// How long loop() blocks waiting for a snapshot or the radio when idle
+#define NET_WAIT_MS 100
+// Connect timeout for the station, cached fast path included
+#define WIFI_CONNECT_TIMEOUT_MS 15000
+// Pause between turning WiFi off and handing the radio to BLE
+#define RADIO_SETTLE_MS 200
 
 // ─── Poll Cycle Data ────────────────────────────────────────
 
-static BroadcastState s_broadcast;
-static ConsumptionEntry *s_qhEntries = nullptr;
-static uint16_t s_qhCount = 0;
-static struct tm s_readTime; // NTP time at moment of BLE read
+static PollSnapshot *s_snapshot = nullptr; // received, not yet published
+static RingView<QhRegion> s_qh = {}; // over the snapshot's mirrors, no copies
+static RingView<DailyRegion> s_daily = {};
+static QhIndex s_qhIndex = {}; // window sums over s_qh (newest-first)
+
+// Everything the network task allocates for one cycle (QH index, JSON
+// documents) comes from here and is reclaimed at the end of the publish
+static uint8_t s_arenaStorage[POLL_ARENA_SIZE];
+static PollArena s_arena;
+static struct tm s_readTime; // wall-clock time of the BLE broadcast read
+static struct tm s_dailyTime; // what the daily ring is current as of (may be an earlier poll)
+
+// QH write index the meter was last published at: every slot completed
+// before it has gone out exactly once (RTC: also across deep sleep)
+RTC_DATA_ATTR static uint16_t s_meterIdx = 0;
+RTC_DATA_ATTR static bool s_meterIdxValid = false;
+
+// Diagnostics carried into the next publish
+static unsigned long s_reconnectMs = 0; // WiFi/NTP/MQTT restore after the last BLE session
+static unsigned long s_publishMs = 0;   // duration of the previous publish
 
 // ─── Helpers ────────────────────────────────────────────────
 
 static void freePollData()
 {
-  if (s_qhEntries)
-  {
-    free(s_qhEntries);
-    s_qhEntries = nullptr;
-  }
-  s_qhCount = 0;
+  s_qh = {};
+  s_daily = {};
+  qhIndexFree(s_qhIndex, s_arena);
+  acqRelease(s_snapshot);
+  s_snapshot = nullptr;
+  arenaReset(s_arena, "Net");
 }
 
 static void changeState(FirmwareState newState)
@@ -64,21 +105,77 @@ static void changeState(FirmwareState newState)
   s_stateTimer = millis();
 }
 
+static unsigned long stateElapsed()
+{
+  return millis() - s_stateTimer;
+}
+
+// Come back to `state` after `delayMs`, with loop() running meanwhile
+static void retryAfter(FirmwareState state, uint32_t delayMs)
+{
+  s_retryState = state;
+  s_retryDelayMs = delayMs;
+  changeState(STATE_RETRY_WAIT);
+}
+
+// Power down until the next poll is due. What the next cycle needs is in
+// RTC memory (mirrors are on flash); the wake-up runs setup() again.
+// Call only while the acquisition task is idle. Returns (staying awake)
+// if the next poll is close.
+static void sleepUntilNextPoll()
+{
+  uint32_t wait = acqMsUntilNextPoll();
+  if (wait < DEEP_SLEEP_MIN_MS)
+    return;
+
+  Serial.printf("[Main] Deep sleep for %lu s\n", (unsigned long)(wait / 1000));
+  mqttDisconnect();
+  wifiOff();
+  Serial.flush();
+  esp_sleep_enable_timer_wakeup((uint64_t)wait * 1000);
+  esp_deep_sleep_start();
+}
+
 // ─── Setup ──────────────────────────────────────────────────
 
 void setup()
 {
   Serial.begin(115200);
-  delay(1000);
-  Serial.println("\n========================================");
-  Serial.println("  BWT BLE-to-MQTT Bridge");
-  Serial.println("========================================");
-  Serial.printf("Free heap: %u bytes\n", ESP.getFreeHeap());
+  bool warmBoot = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+  if (warmBoot)
+  {
+    Serial.println("\n[Main] Woke from deep sleep");
+  }
+  else
+  {
+    delay(1000);
+    Serial.println("\n========================================");
+    Serial.println("  BWT BLE-to-MQTT Bridge");
+    Serial.println("========================================");
+    Serial.printf("Free heap: %u bytes\n", ESP.getFreeHeap());
+  }
+
+  arenaInit(s_arena, s_arenaStorage, sizeof(s_arenaStorage));
+  mqttUseArena(&s_arena);
 
-  // Initialize BLE
+  // Initialize BLE and start polling it on the other core
+  timeInit();
   bleInit();
+  acqStart();
 
-  changeState(STATE_WIFI_CONNECT);
+  if (warmBoot)
+  {
+    // Straight to the fetch: the radio starts out lent to BLE, WiFi
+    // comes back (fast path) once the poll is done
+    acqRadioGrant();
+    s_radioGranted = true;
+    acqRequestPoll();
+    changeState(STATE_RADIO_LENT);
+  }
+  else
+  {
+    changeState(STATE_WIFI_CONNECT);
+  }
 }
 
 // ─── Loop ───────────────────────────────────────────────────
@@ -91,6 +188,33 @@ void loop()
     mqttLoop();
   }
 
+  // Drive NTP while the station is up: starts a sync when one is due and
+  // checks on it, never waits for the answer
+  if (WiFi.status() == WL_CONNECTED)
+  {
+    timeService();
+  }
+
+  // The acquisition task wants the radio: hand it over between steps
+  if (WIFI_BLE_COEXIST && acqRadioWanted())
+  {
+    // Coexistence: WiFi and MQTT stay up, nothing to hand back afterwards
+    acqRadioGrant();
+    s_reconnectMs = 0;
+  }
+  else if (s_state != STATE_RADIO_LENT && s_state != STATE_MQTT_PUBLISH && acqRadioWanted())
+  {
+    // Disable WiFi to free the radio for BLE — they share the same
+    // antenna/radio on ESP32. Eliminates packet loss during BLE.
+    // The grant follows once the WiFi stack has settled.
+    Serial.println("[Main] Turning off WiFi for BLE operations...");
+    mqttDisconnect();
+    wifiOff();
+    s_radioGranted = false;
+    s_reconnectStart = 0;
+    changeState(STATE_RADIO_LENT);
+  }
+
   switch (s_state)
   {
 
@@ -98,55 +222,43 @@ void loop()
   case STATE_WIFI_CONNECT:
   {
     Serial.printf("[WiFi] Connecting to %s...\n", WIFI_SSID);
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+    wifiConnectStart(WIFI_CONNECT_TIMEOUT_MS);
+    changeState(STATE_WIFI_WAIT);
+    break;
+  }
+
+  case STATE_WIFI_WAIT:
+  {
+    WifiLinkState link = wifiConnectStep();
+    if (link == WIFI_LINK_PENDING)
+      break;
 
-    unsigned long wifiStart = millis();
-    while (WiFi.status() != WL_CONNECTED &&
-           (millis() - wifiStart) < 15000)
+    if (link == WIFI_LINK_FAILED)
     {
-      delay(500);
-      Serial.print(".");
+      // A pending snapshot stays queued until the network is back
+      Serial.println("[WiFi] Connection failed, retrying in 5s...");
+      s_reconnectStart = 0;
+      retryAfter(STATE_WIFI_CONNECT, 5000);
+      break;
     }
-    Serial.println();
 
-    if (WiFi.status() == WL_CONNECTED)
-    {
-      Serial.printf("[WiFi] Connected! IP: %s\n",
-                    WiFi.localIP().toString().c_str());
-
-      // Initialize NTP time sync
-      configTzTime(NTP_TZ, NTP_SERVER);
-      Serial.println("[NTP] Syncing time...");
-      time_t now = time(nullptr);
-      int ntpWait = 0;
-      while (now < 1700000000 && ntpWait < 50) // wait up to 10s
-      {
-        delay(200);
-        now = time(nullptr);
-        ntpWait++;
-      }
-      if (now > 1700000000)
-      {
-        struct tm ti;
-        localtime_r(&now, &ti);
-        char buf[32];
-        strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &ti);
-        Serial.printf("[NTP] Time: %s\n", buf);
-      }
-      else
-      {
-        Serial.println("[NTP] Warning: time sync failed");
-      }
+    Serial.printf("[WiFi] Connected! IP: %s\n",
+                  WiFi.localIP().toString().c_str());
+    mqttInit(); // re-set server in case WiFiClient was reset
 
-      mqttInit();
-      changeState(STATE_MQTT_CONNECT);
-    }
-    else
+    // First NTP sync: the first poll should already carry real dates.
+    // Later cycles re-sync in the background when due.
+    changeState(timeValid() ? STATE_MQTT_CONNECT : STATE_TIME_SYNC);
+    break;
+  }
+
+  // ── Wait for the first NTP sync ─────────────────────────
+  case STATE_TIME_SYNC:
+  {
+    // timeService() above started the sync and logs how it ends
+    if (timeValid() || stateElapsed() >= NTP_SYNC_TIMEOUT_MS)
     {
-      Serial.println("[WiFi] Connection failed, retrying in 5s...");
-      delay(5000);
-      // stay in STATE_WIFI_CONNECT
+      changeState(STATE_MQTT_CONNECT);
     }
     break;
   }
@@ -161,17 +273,24 @@ void loop()
       break;
     }
 
+    // Fresh MQTT connection on clean TCP socket; bounded by the client's
+    // socket timeout
     if (mqttConnect())
     {
-      // Publish HA discovery on first connect
+      // Publish HA discovery on first connect, then trigger the first poll
       if (!s_haDiscoverySent)
       {
         mqttPublishHADiscovery();
         s_haDiscoverySent = true;
+        acqRequestPoll();
+      }
+      if (s_reconnectStart)
+      {
+        s_reconnectMs = millis() - s_reconnectStart;
+        s_reconnectStart = 0;
+        Serial.printf("[Main] Network restored in %lu ms\n", s_reconnectMs);
       }
       s_retryCount = 0;
-      // Trigger first poll immediately
-      s_lastPoll = millis() - POLL_INTERVAL_MS;
       changeState(STATE_IDLE);
     }
     else
@@ -180,12 +299,22 @@ void loop()
       uint32_t backoff = min((uint32_t)s_retryCount * 5000, (uint32_t)30000);
       Serial.printf("[MQTT] Retry in %lu ms (attempt %u)\n",
                     (unsigned long)backoff, s_retryCount);
-      delay(backoff);
+      retryAfter(STATE_MQTT_CONNECT, backoff);
     }
     break;
   }
 
-  // ── Idle (wait for poll interval) ───────────────────────
+  // ── Back off before retrying a connect ──────────────────
+  case STATE_RETRY_WAIT:
+  {
+    if (stateElapsed() >= s_retryDelayMs)
+    {
+      changeState(s_retryState);
+    }
+    break;
+  }
+
+  // ── Idle (wait for the next snapshot) ───────────────────
   case STATE_IDLE:
   {
     // Check WiFi
@@ -201,269 +330,176 @@ void loop()
       break;
     }
 
-    if ((millis() - s_lastPoll) >= POLL_INTERVAL_MS)
+    // A snapshot held back by a reconnect goes out first
+    if (!s_snapshot)
     {
-      Serial.println("\n──── Starting poll cycle ────");
-      Serial.printf("Free heap: %u bytes\n", ESP.getFreeHeap());
-      freePollData();
-      changeState(STATE_BLE_SCAN);
+      s_snapshot = acqReceive(NET_WAIT_MS);
     }
-    break;
-  }
-
-  // ── BLE Scan ────────────────────────────────────────────
-  case STATE_BLE_SCAN:
-  {
-    // Disable WiFi to free the radio for BLE — they share the same
-    // antenna/radio on ESP32. Eliminates packet loss during BLE.
-    Serial.println("[Main] Turning off WiFi for BLE operations...");
-    mqttDisconnect();
-    WiFi.disconnect(true);
-    WiFi.mode(WIFI_OFF);
-    delay(200);
-    Serial.printf("[Main] WiFi off, free heap: %u bytes\n", ESP.getFreeHeap());
-
-    if (bleScan())
-    {
-      changeState(STATE_BLE_CONNECT);
-    }
-    else
+    if (s_snapshot)
     {
-      Serial.println("[Main] BLE scan failed, retry next cycle");
-      s_lastPoll = millis();
-      // Re-enable WiFi before going idle
-      changeState(STATE_BLE_DISCONNECT);
+      changeState(STATE_MQTT_PUBLISH);
+      break;
     }
-    break;
-  }
 
-  // ── BLE Connect ─────────────────────────────────────────
-  case STATE_BLE_CONNECT:
-  {
-    if (bleConnect())
+    // Sleep once the acquisition task has saved its mirrors
+    if (s_sleepPending && acqWaitIdle(0))
     {
-      changeState(STATE_READ_BROADCAST);
-    }
-    else
-    {
-      Serial.println("[Main] BLE connect failed, retry next cycle");
-      bleDisconnect();
-      s_lastPoll = millis();
-      changeState(STATE_BLE_DISCONNECT); // re-enables WiFi
+      s_sleepPending = false;
+      sleepUntilNextPoll();
     }
     break;
   }
 
-  // ── Read Broadcast ──────────────────────────────────────
-  case STATE_READ_BROADCAST:
+  // ── Radio lent to BLE ───────────────────────────────────
+  case STATE_RADIO_LENT:
   {
-    if (!bleIsConnected())
+    if (!s_radioGranted)
     {
-      Serial.println("[Main] Lost BLE connection");
-      changeState(STATE_BLE_DISCONNECT);
-      break;
+      if (stateElapsed() < RADIO_SETTLE_MS)
+        break;
+      Serial.printf("[Main] WiFi off, free heap: %u bytes\n", ESP.getFreeHeap());
+      acqRadioGrant();
+      s_radioGranted = true;
     }
+    if (!acqRadioReturned(NET_WAIT_MS))
+      break;
 
-    if (bleReadBroadcast(s_broadcast))
-    {
-      changeState(STATE_FETCH_QH);
-    }
-    else
-    {
-      Serial.println("[Main] Broadcast read failed");
-      changeState(STATE_BLE_DISCONNECT);
-    }
+    // Re-enable WiFi (was turned off before handing the radio to BLE);
+    // MQTT_CONNECT reports how long the whole restore took
+    Serial.println("[Main] BLE done, re-enabling WiFi...");
+    s_radioGranted = false;
+    s_reconnectStart = millis();
+    changeState(STATE_WIFI_CONNECT);
     break;
   }
 
-  // ── Fetch Quarter-Hour Data ─────────────────────────────
-  case STATE_FETCH_QH:
+  // ── MQTT Publish ────────────────────────────────────────
+  case STATE_MQTT_PUBLISH:
   {
-    if (!bleIsConnected())
+    // Keep the snapshot and publish it once reconnected
+    if (!mqttIsConnected())
     {
-      changeState(STATE_BLE_DISCONNECT);
+      Serial.println("[Main] MQTT not connected, publishing after reconnect");
+      changeState(STATE_MQTT_CONNECT);
       break;
     }
 
-    uint16_t regionSize = QH_END_ADDR - QH_START_ADDR;
-    uint16_t reqSize = calculateRequestSize(
-        s_broadcast.quarterHoursIdx, s_broadcast.quarterHoursLooped, regionSize);
+    unsigned long publishStart = millis();
+    // Dates are relative to when the device was read, not published
+    time_t readAt = s_snapshot->readAt ? s_snapshot->readAt : timeNow();
+    localtime_r(&readAt, &s_readTime);
 
-    if (reqSize == 0)
+    // View the snapshot's rings in place; the acquisition task may already
+    // be working on the next poll
+    if (s_snapshot->dailyOk)
     {
-      Serial.println("[Main] No QH data to fetch");
-      changeState(STATE_BLE_DISCONNECT);
-      break;
+      s_daily = ringView<DailyRegion>(s_snapshot->daily);
+      time_t dailyAt = s_snapshot->dailyAt ? s_snapshot->dailyAt : readAt;
+      localtime_r(&dailyAt, &s_dailyTime);
+      Serial.printf("[Main] Daily: %u entries\n", s_daily.count);
     }
-
-    PacketCollector collector;
-    if (!collectorInit(collector, reqSize))
+    s_qh = ringView<QhRegion>(s_snapshot->qh);
+    if (s_qh.count == 0)
     {
-      Serial.println("[Main] QH collector init failed");
-      changeState(STATE_BLE_DISCONNECT);
-      break;
-    }
-
-    if (bleFetchDataset(QH_START_ADDR, reqSize, collector))
-    {
-      uint16_t numEntries = collector.bufferLen / 2;
-      s_qhEntries = (ConsumptionEntry *)malloc(numEntries * sizeof(ConsumptionEntry));
-      if (s_qhEntries)
-      {
-        s_qhCount = parseBuffer(collector.buffer, collector.bufferLen,
-                                s_qhEntries, false);
-
-        // Debug: dump first raw bytes and parsed values
-        Serial.printf("[Main] QH raw hex (first 20 bytes): ");
-        for (uint16_t db = 0; db < 20 && db < collector.bufferLen; db++)
-          Serial.printf("%02X ", collector.buffer[db]);
-        Serial.println();
-        Serial.printf("[Main] QH first 5 parsed: ");
-        for (uint16_t dp = 0; dp < 5 && dp < s_qhCount; dp++)
-          Serial.printf("[%u]=%uL ", dp, s_qhEntries[dp].litres);
-        Serial.println();
-
-        rotateRingBuffer(s_qhEntries, s_qhCount,
-                         s_broadcast.quarterHoursIdx,
-                         s_broadcast.quarterHoursLooped);
-        Serial.printf("[Main] QH: %u entries parsed\n", s_qhCount);
-      }
+      Serial.println("[Main] Snapshot has no QH data; skipping QH publishes");
     }
     else
     {
-      Serial.println("[Main] QH fetch failed");
+      // Debug: dump first raw bytes and the oldest decoded values
+      Serial.printf("[Main] QH raw hex (first 20 bytes): ");
+      for (uint16_t db = 0; db < 20 && db < s_qh.count * 2; db++)
+        Serial.printf("%02X ", s_snapshot->qh.data[db]);
+      Serial.println();
+      Serial.printf("[Main] QH oldest 5: ");
+      for (uint16_t dp = 0; dp < 5 && dp < s_qh.count; dp++)
+        Serial.printf("[%u]=%uL ", dp, ringOldest(s_qh, dp).litres);
+      Serial.println();
+      Serial.printf("[Main] QH: %u entries\n", s_qh.count);
     }
 
-    collectorFree(collector);
-    changeState(STATE_BLE_DISCONNECT);
-    break;
-  }
-
-  // ── BLE Disconnect ──────────────────────────────────────
-  case STATE_BLE_DISCONNECT:
-  {
-    bleDisconnect();
-
-    // Re-enable WiFi (was turned off before BLE scan)
-    Serial.println("[Main] BLE done, re-enabling WiFi...");
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-    unsigned long wifiStart = millis();
-    while (WiFi.status() != WL_CONNECTED && (millis() - wifiStart) < 15000)
-    {
-      delay(250);
-    }
+    // Publish device status (remaining capacity, alarm, etc.)
+    mqttPublishStatus(s_snapshot->broadcast);
 
-    if (WiFi.status() != WL_CONNECTED)
+    // One pass over the QH slots; every window sum below is O(1) from here
+    if (s_qh.count > 0 && !qhIndexBuild(s_qhIndex, s_qh, s_arena))
     {
-      Serial.println("[Main] WiFi reconnect failed, skipping publish");
-      freePollData();
-      s_lastPoll = millis();
-      changeState(STATE_WIFI_CONNECT);
-      break;
+      Serial.println("[Main] No memory for the QH index");
     }
 
-    Serial.printf("[Main] WiFi reconnected, IP: %s\n",
-                  WiFi.localIP().toString().c_str());
-
-    // Re-sync NTP after WiFi reconnect (SNTP client is lost after WiFi off)
-    configTzTime(NTP_TZ, NTP_SERVER);
+    // Meter: each 15-min slot completed since the last publish, oldest
+    // first. Index 0 is the in-progress slot; index k is the k-th most
+    // recently completed one. A poll within the same slot publishes nothing.
+    if (PUBLISH_METER && s_qh.count >= 2)
     {
-      time_t now = time(nullptr);
-      int ntpWait = 0;
-      while (now < 1700000000 && ntpWait < 50) // wait up to 10s
+      uint16_t idx = s_snapshot->broadcast.quarterHoursIdx;
+      uint16_t fresh = s_meterIdxValid ? (idx + QhRegion::words - s_meterIdx) % QhRegion::words : 1;
+      if (fresh > METER_MAX_CATCHUP_SLOTS)
       {
-        delay(200);
-        now = time(nullptr);
-        ntpWait++;
+        Serial.printf("[Main] %u slots since last meter publish, sending the last %u\n",
+                      fresh, METER_MAX_CATCHUP_SLOTS);
+        fresh = METER_MAX_CATCHUP_SLOTS;
       }
-      if (now > 1700000000)
+      if (fresh > s_qh.count - 1)
+        fresh = s_qh.count - 1;
+      for (uint16_t k = fresh; k >= 1; k--)
       {
-        localtime_r(&now, &s_readTime);
-        char buf[32];
-        strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &s_readTime);
-        Serial.printf("[NTP] Time re-synced: %s\n", buf);
-      }
-      else
-      {
-        Serial.println("[NTP] Warning: time re-sync failed, dates will be wrong");
-        // Still capture whatever time we have
-        localtime_r(&now, &s_readTime);
+        if (!mqttPublishMeter(ringLitres(s_qh, k)))
+          break;
+        s_meterIdx = (idx + QhRegion::words - (k - 1)) % QhRegion::words;
+        s_meterIdxValid = true;
       }
     }
 
-    // Fresh MQTT connection on clean TCP socket
-    mqttInit(); // re-set server in case WiFiClient was reset
-    if (!mqttConnect())
+    // Daily history with calendar dates: straight from the device's daily
+    // ring (dated from its last sync, which may be an earlier poll),
+    // otherwise computed from QH sums
+    if (PUBLISH_DAILY_HISTORY)
     {
-      Serial.println("[Main] MQTT connect failed after BLE, retrying...");
-      delay(2000);
-      if (!mqttConnect())
+      if (s_daily.count > 0)
       {
-        Serial.println("[Main] MQTT connect failed twice, skipping publish");
-        freePollData();
-        s_lastPoll = millis();
-        changeState(STATE_IDLE);
-        break;
+        mqttPublishDailyTotals(s_daily, s_dailyTime);
+      }
+      else if (s_qhIndex.count > 0)
+      {
+        mqttPublishDailyHistory(s_qhIndex, s_readTime);
       }
     }
 
-    changeState(STATE_MQTT_PUBLISH);
-    break;
-  }
-
-  // ── MQTT Publish ────────────────────────────────────────
-  case STATE_MQTT_PUBLISH:
-  {
-    // Verify MQTT is alive (should be — reconnected in BLE_DISCONNECT)
-    if (!mqttEnsureConnected())
+    // Hourly history with timestamps
+    if (PUBLISH_HOURLY_HISTORY && s_qhIndex.count > 0)
     {
-      Serial.println("[Main] MQTT not connected, skipping publish");
-      freePollData();
-      s_lastPoll = millis();
-      changeState(STATE_IDLE);
-      break;
+      mqttPublishHourlyHistory(s_qhIndex, s_readTime);
     }
 
-    // Publish device status (remaining capacity, alarm, etc.)
-    mqttPublishStatus(s_broadcast);
-
-    if (s_qhEntries && s_qhCount > 0)
+    // Rolling 24 h / 7 d totals
+    if (PUBLISH_ROLLING_TOTALS && s_qhIndex.count > 0)
     {
-      // Reverse QH array to newest-first order
-      for (uint16_t i = 0; i < s_qhCount / 2; i++)
-      {
-        ConsumptionEntry tmp = s_qhEntries[i];
-        s_qhEntries[i] = s_qhEntries[s_qhCount - 1 - i];
-        s_qhEntries[s_qhCount - 1 - i] = tmp;
-      }
-
-      // Meter: last completed 15-min consumption.
-      // Index 0 is the in-progress slot; index 1 is the last fully completed one.
-      if (PUBLISH_METER && s_qhCount >= 2)
-      {
-        mqttPublishMeter(s_qhEntries[1].litres);
-      }
-
-      // Daily history with calendar dates (computed from QH sums)
-      if (PUBLISH_DAILY_HISTORY)
-      {
-        mqttPublishDailyHistory(s_qhEntries, s_qhCount, s_readTime);
-      }
+      mqttPublishRollingTotals(s_qhIndex, s_readTime);
+    }
 
-      // Hourly history with timestamps
-      if (PUBLISH_HOURLY_HISTORY)
-      {
-        mqttPublishHourlyHistory(s_qhEntries, s_qhCount, s_readTime);
-      }
+    if (PUBLISH_DIAGNOSTICS)
+    {
+      CycleDiagnostics diag;
+      diag.cycle = s_snapshot->cycle;
+      diag.coexist = WIFI_BLE_COEXIST;
+      diag.bleMs = s_snapshot->bleMs;
+      diag.reconnectMs = s_reconnectMs;
+      diag.publishMs = s_publishMs;
+      diag.link = s_snapshot->link;
+      mqttPublishDiagnostics(diag);
     }
+    s_publishMs = millis() - publishStart;
 
-    // Done — free data and go idle
+    // Done — free data, return the snapshot and go idle
+    Serial.printf("[Main] Cycle %lu published (BLE %lu ms)\n",
+                  (unsigned long)s_snapshot->cycle, s_snapshot->bleMs);
     freePollData();
-    s_lastPoll = millis();
     Serial.println("──── Poll cycle complete ────\n");
     Serial.printf("Free heap: %u bytes\n", ESP.getFreeHeap());
     changeState(STATE_IDLE);
+
+    if (DEEP_SLEEP_ENABLED)
+      s_sleepPending = true;
     break;
   }
 
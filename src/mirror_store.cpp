@@ -0,0 +1,210 @@
+#include "mirror_store.h"
+#include "ring_mirror.h"
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <ctype.h>
+#include <string.h>
+
+// Layout on flash (one directory per device):
+//   /bwt_<MAC>/<tag>.hdr  MirrorHeader
+//   /bwt_<MAC>/<tag>.NN   raw bytes of page NN (MIRROR_PAGE_SIZE, last may be shorter)
+// LittleFS rewrites a file from the first modified block to its end, so
+// keeping pages in separate small files bounds each save to the dirty pages.
+// Before any page is rewritten the header is marked invalid, and the real
+// header is written last. A power loss mid-save (say, halfway through
+// overwriting every page after a full refetch) then leaves a mirror that
+// is ignored on the next boot, never old metadata over a mix of old and
+// new pages.
+
+#define STORE_MAGIC 0x4D545742UL // "BWTM"
+#define STORE_VERSION 1
+
+struct MirrorHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t startAddr;
+    uint16_t regionSize;
+    uint16_t idx;
+    uint8_t looped;
+    uint8_t valid;
+    uint16_t reserved;
+    uint32_t syncedEpoch;
+};
+
+static bool s_mounted = false;
+
+// ─── Helpers ────────────────────────────────────────────────
+
+// "AA:BB:CC:DD:EE:FF" -> "/bwt_AABBCCDDEEFF"
+static void buildDir(const char *deviceAddr, char *out, size_t outLen)
+{
+    size_t n = snprintf(out, outLen, "/bwt_");
+    for (const char *p = deviceAddr; *p && n + 1 < outLen; p++)
+    {
+        if (isxdigit((unsigned char)*p))
+            out[n++] = toupper((unsigned char)*p);
+    }
+    out[n] = '\0';
+}
+
+static bool readFile(const char *path, uint8_t *buf, size_t len)
+{
+    File f = LittleFS.open(path, FILE_READ);
+    if (!f)
+        return false;
+    size_t got = f.read(buf, len);
+    f.close();
+    return got == len;
+}
+
+static bool writeFile(const char *path, const uint8_t *buf, size_t len)
+{
+    File f = LittleFS.open(path, FILE_WRITE);
+    if (!f)
+        return false;
+    size_t put = f.write(buf, len);
+    f.close();
+    return put == len;
+}
+
+static uint16_t pageLen(const RingMirror &m, uint8_t page)
+{
+    uint16_t offset = page * MIRROR_PAGE_SIZE;
+    uint16_t remaining = m.regionSize - offset;
+    return remaining < MIRROR_PAGE_SIZE ? remaining : MIRROR_PAGE_SIZE;
+}
+
+// ─── Public Functions ───────────────────────────────────────
+
+bool storeInit()
+{
+    s_mounted = LittleFS.begin(true);
+    if (s_mounted)
+    {
+        Serial.printf("[Store] LittleFS mounted: %u/%u bytes used\n",
+                      (unsigned)LittleFS.usedBytes(), (unsigned)LittleFS.totalBytes());
+    }
+    else
+    {
+        Serial.println("[Store] LittleFS mount failed, mirrors will not persist");
+    }
+    return s_mounted;
+}
+
+bool storeLoad(RingMirror &m, const char *deviceAddr, const char *tag)
+{
+    if (!s_mounted)
+        return false;
+
+    char dir[24];
+    char path[40];
+    buildDir(deviceAddr, dir, sizeof(dir));
+
+    MirrorHeader hdr;
+    snprintf(path, sizeof(path), "%s/%s.hdr", dir, tag);
+    if (!readFile(path, (uint8_t *)&hdr, sizeof(hdr)))
+        return false;
+
+    if (hdr.magic != STORE_MAGIC || hdr.version != STORE_VERSION ||
+        hdr.startAddr != m.startAddr || hdr.regionSize != m.regionSize || !hdr.valid ||
+        hdr.idx >= m.regionSize / 2)
+    {
+        Serial.printf("[Store] %s: header mismatch, ignoring\n", path);
+        return false;
+    }
+
+    uint8_t pages = mirrorPageCount(m);
+    for (uint8_t p = 0; p < pages; p++)
+    {
+        uint8_t *dst = m.data + p * MIRROR_PAGE_SIZE;
+        snprintf(path, sizeof(path), "%s/%s.%02u", dir, tag, p);
+        if (readFile(path, dst, pageLen(m, p)))
+            continue;
+
+        // Pages past the write index of a ring that never looped were
+        // never fetched, so they were never saved either
+        if (!hdr.looped && (uint32_t)p * MIRROR_PAGE_SIZE >= 2UL * hdr.idx)
+        {
+            memset(dst, 0, pageLen(m, p));
+        }
+        else
+        {
+            Serial.printf("[Store] %s: missing or short, ignoring saved mirror\n", path);
+            mirrorInvalidate(m);
+            return false;
+        }
+    }
+
+    m.idx = hdr.idx;
+    m.looped = hdr.looped != 0;
+    m.valid = true;
+    m.syncedAt = millis();
+    m.syncedEpoch = hdr.syncedEpoch;
+    m.dirtyPages = 0;
+    m.metaDirty = false;
+
+    Serial.printf("[Store] Restored %s mirror for %s: idx=%u, looped=%d\n",
+                  tag, dir + 5, m.idx, m.looped);
+    return true;
+}
+
+bool storeSave(RingMirror &m, const char *deviceAddr, const char *tag)
+{
+    if (!s_mounted || (!m.metaDirty && m.dirtyPages == 0))
+        return true;
+
+    char dir[24];
+    char path[40];
+    buildDir(deviceAddr, dir, sizeof(dir));
+    if (!LittleFS.exists(dir))
+        LittleFS.mkdir(dir);
+
+    MirrorHeader hdr = {};
+    hdr.magic = STORE_MAGIC;
+    hdr.version = STORE_VERSION;
+    hdr.startAddr = m.startAddr;
+    hdr.regionSize = m.regionSize;
+    snprintf(path, sizeof(path), "%s/%s.hdr", dir, tag);
+
+    // valid = 0 until every dirty page below is on flash
+    if (m.dirtyPages != 0 && !writeFile(path, (const uint8_t *)&hdr, sizeof(hdr)))
+    {
+        Serial.printf("[Store] Write failed: %s\n", path);
+        return false;
+    }
+
+    uint8_t pages = mirrorPageCount(m);
+    uint8_t written = 0;
+    for (uint8_t p = 0; p < pages && p < MIRROR_MAX_PAGES; p++)
+    {
+        if (!(m.dirtyPages & (1UL << p)))
+            continue;
+        snprintf(path, sizeof(path), "%s/%s.%02u", dir, tag, p);
+        if (!writeFile(path, m.data + p * MIRROR_PAGE_SIZE, pageLen(m, p)))
+        {
+            Serial.printf("[Store] Write failed: %s\n", path);
+            return false;
+        }
+        m.dirtyPages &= ~(1UL << p);
+        written++;
+    }
+
+    hdr.idx = m.idx;
+    hdr.looped = m.looped;
+    hdr.valid = m.valid;
+    hdr.syncedEpoch = m.syncedEpoch;
+
+    snprintf(path, sizeof(path), "%s/%s.hdr", dir, tag);
+    if (!writeFile(path, (const uint8_t *)&hdr, sizeof(hdr)))
+    {
+        Serial.printf("[Store] Write failed: %s\n", path);
+        return false;
+    }
+    m.metaDirty = false;
+
+    Serial.printf("[Store] Saved %s mirror: %u page(s) + header, idx=%u\n",
+                  tag, written, m.idx);
+    return true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "ring_mirror.h"
+#include <stdint.h>
+
+/**
+ * Mount the LittleFS partition used for mirror persistence.
+ * Formats it on first use. Call once in setup().
+ * Returns false if flash storage is unavailable; mirrors then stay RAM-only.
+ */
+bool storeInit();
+
+/**
+ * Load a mirror saved for `deviceAddr` (BLE MAC, any separator) under `tag`.
+ * Only restores data whose region geometry matches `m`.
+ * Returns true if a valid mirror was restored.
+ */
+bool storeLoad(RingMirror &m, const char *deviceAddr, const char *tag);
+
+/**
+ * Save a mirror for `deviceAddr` under `tag`.
+ * Only pages marked dirty since the last save are written, each page in
+ * its own small file. The saved header is marked invalid before the first
+ * page and rewritten with idx/looped flags after the last, so an
+ * interrupted save is ignored by storeLoad().
+ * Returns true if nothing needed saving or all writes succeeded.
+ */
+bool storeSave(RingMirror &m, const char *deviceAddr, const char *tag);
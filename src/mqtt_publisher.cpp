@@ -1,6 +1,8 @@
 #include "mqtt_publisher.h"
 #include "config.h"
 #include "bwt_protocol.h"
+#include "timeline.h"
+#include "poll_arena.h"
 
 #include <Arduino.h>
 #include <WiFi.h>
@@ -8,20 +10,129 @@
 #include <ArduinoJson.h>
 #include <time.h>
 
+// Serializer output is gathered into chunks of this size before it goes
+// to the socket
+#define MQTT_WRITE_CHUNK 256
+
 // ─── Module State ───────────────────────────────────────────
 
 static WiFiClient s_wifiClient;
 static PubSubClient s_mqtt(s_wifiClient);
 
+// JSON documents draw from the network task's poll arena when one is set
+class ArenaJsonAllocator : public ArduinoJson::Allocator
+{
+public:
+    PollArena *arena = nullptr;
+
+    void *allocate(size_t size) override
+    {
+        return arena ? arenaAlloc(*arena, size) : malloc(size);
+    }
+
+    void deallocate(void *ptr) override
+    {
+        if (arena)
+            arenaFree(*arena, ptr);
+        else
+            free(ptr);
+    }
+
+    void *reallocate(void *ptr, size_t size) override
+    {
+        return arena ? arenaRealloc(*arena, ptr, size) : realloc(ptr, size);
+    }
+};
+
+static ArenaJsonAllocator s_jsonAllocator;
+
 // ─── Helper: build topic string ─────────────────────────────
 
-static String buildTopic(const char *suffix)
+// Valid until the next call; ArduinoJson copies it when stored in a document
+static const char *buildTopic(const char *suffix)
+{
+    static char topic[96];
+    snprintf(topic, sizeof(topic), "%s/%s", MQTT_TOPIC_PREFIX, suffix);
+    return topic;
+}
+
+// ─── Helper: stream JSON into a publish ─────────────────────
+
+// Print sink between serializeJson() and PubSubClient's streaming publish.
+// Without it every JSON token would be its own TCP write.
+class PublishWriter : public Print
+{
+public:
+    size_t write(uint8_t c) override
+    {
+        if (m_len == sizeof(m_buf) && !drain())
+            return 0;
+        m_buf[m_len++] = c;
+        return 1;
+    }
+
+    size_t write(const uint8_t *data, size_t size) override
+    {
+        size_t done = 0;
+        while (done < size)
+        {
+            if (m_len == sizeof(m_buf) && !drain())
+                break;
+            size_t n = min(size - done, sizeof(m_buf) - m_len);
+            memcpy(m_buf + m_len, data + done, n);
+            m_len += n;
+            done += n;
+        }
+        return done;
+    }
+
+    // Hand the buffered bytes to the client; false once the socket failed
+    bool drain()
+    {
+        if (m_len > 0 && s_mqtt.write(m_buf, m_len) != m_len)
+            m_failed = true;
+        m_len = 0;
+        return !m_failed;
+    }
+
+private:
+    uint8_t m_buf[MQTT_WRITE_CHUNK];
+    size_t m_len = 0;
+    bool m_failed = false;
+};
+
+// Publish `doc` without materialising the serialized payload: the length
+// goes into the MQTT header up front, then the serializer writes straight
+// to the socket. PubSubClient's own buffer only ever holds the header and
+// topic. The document itself is still built in RAM first; one that ran
+// out of memory while being filled is incomplete and is not published.
+static bool publishJson(const char *topic, const JsonDocument &doc,
+                        bool retained, size_t &length)
 {
-    return String(MQTT_TOPIC_PREFIX) + "/" + suffix;
+    length = 0;
+    if (doc.overflowed())
+    {
+        Serial.printf("[MQTT] %s: JSON document overflowed, not publishing\n", topic);
+        return false;
+    }
+
+    length = measureJson(doc);
+    if (!s_mqtt.beginPublish(topic, length, retained))
+        return false;
+
+    PublishWriter writer;
+    bool ok = serializeJson(doc, writer) == length && writer.drain();
+    // endPublish() must always run to leave the client's publish state
+    return s_mqtt.endPublish() == 1 && ok;
 }
 
 // ─── Public Functions ───────────────────────────────────────
 
+void mqttUseArena(PollArena *arena)
+{
+    s_jsonAllocator.arena = arena;
+}
+
 void mqttInit()
 {
     s_mqtt.setServer(MQTT_HOST, MQTT_PORT);
@@ -67,52 +178,6 @@ void mqttDisconnect()
     s_wifiClient.stop();
 }
 
-bool mqttForceReconnect()
-{
-    Serial.println("[MQTT] Force reconnecting (fresh TCP socket)...");
-    s_mqtt.disconnect();
-    s_wifiClient.stop();
-    delay(500);
-
-    // Re-check WiFi
-    if (WiFi.status() != WL_CONNECTED)
-    {
-        Serial.println("[MQTT] WiFi down, reconnecting...");
-        WiFi.disconnect();
-        WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-        unsigned long wifiStart = millis();
-        while (WiFi.status() != WL_CONNECTED && (millis() - wifiStart) < 10000)
-        {
-            delay(250);
-        }
-        if (WiFi.status() != WL_CONNECTED)
-        {
-            Serial.println("[MQTT] WiFi reconnect failed");
-            return false;
-        }
-        Serial.printf("[MQTT] WiFi reconnected, IP: %s\n",
-                      WiFi.localIP().toString().c_str());
-    }
-    else
-    {
-        Serial.printf("[MQTT] WiFi OK, IP: %s\n",
-                      WiFi.localIP().toString().c_str());
-    }
-
-    // Reconnect MQTT
-    return mqttConnect();
-}
-
-bool mqttEnsureConnected()
-{
-    if (s_mqtt.connected())
-    {
-        s_mqtt.loop();
-        return true;
-    }
-    return mqttForceReconnect();
-}
-
 void mqttLoop()
 {
     s_mqtt.loop();
@@ -127,7 +192,7 @@ bool mqttIsConnected()
 
 bool mqttPublishStatus(const BroadcastState &state)
 {
-    JsonDocument doc;
+    JsonDocument doc(&s_jsonAllocator);
 
     doc["remaining_litres"] = state.remaining;
     doc["total_capacity_litres"] = state.totalCapacity;
@@ -156,13 +221,38 @@ bool mqttPublishStatus(const BroadcastState &state)
     strftime(tsBuf, sizeof(tsBuf), "%Y-%m-%dT%H:%M:%S", &timeinfo);
     doc["timestamp"] = tsBuf;
 
-    String payload;
-    serializeJson(doc, payload);
-
-    String topic = buildTopic("status");
-    bool ok = s_mqtt.publish(topic.c_str(), payload.c_str(), true); // retained
+    size_t length;
+    bool ok = publishJson(buildTopic("status"), doc, true, length); // retained
     Serial.printf("[MQTT] Published status (%u bytes): %s\n",
-                  payload.length(), ok ? "OK" : "FAIL");
+                  length, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// ─── Publish Diagnostics ────────────────────────────────────
+
+bool mqttPublishDiagnostics(const CycleDiagnostics &diag)
+{
+    JsonDocument doc(&s_jsonAllocator);
+
+    doc["cycle"] = diag.cycle;
+    doc["radio_mode"] = diag.coexist ? "coexist" : "exclusive";
+    doc["ble_ms"] = diag.bleMs;
+    doc["reconnect_ms"] = diag.reconnectMs;
+    doc["publish_ms"] = diag.publishMs;
+    doc["packets_requested"] = diag.link.requested;
+    doc["packets_lost_first_pass"] = diag.link.firstPassLost;
+    doc["packets_retransmitted"] = diag.link.retransmitted;
+    doc["packets_unrecovered"] = diag.link.unrecovered;
+    doc["frames_dropped"] = diag.link.droppedFrames;
+    if (diag.link.requested > 0)
+    {
+        doc["loss_pct"] = 100.0 * diag.link.firstPassLost / diag.link.requested;
+    }
+
+    size_t length;
+    bool ok = publishJson(buildTopic("diag"), doc, false, length);
+    Serial.printf("[MQTT] Published diagnostics (%u bytes): %s\n",
+                  length, ok ? "OK" : "FAIL");
     return ok;
 }
 
@@ -173,29 +263,23 @@ bool mqttPublishMeter(uint16_t litres)
     char payload[16];
     snprintf(payload, sizeof(payload), "%u", litres);
 
-    String topic = buildTopic("meter");
-    bool ok = s_mqtt.publish(topic.c_str(), payload, true); // retained
+    bool ok = s_mqtt.publish(buildTopic("meter"), payload, true); // retained
     Serial.printf("[MQTT] Meter: %u L -> %s\n", litres, ok ? "OK" : "FAIL");
     return ok;
 }
 
 // ─── Publish Daily History ──────────────────────────────────
 
-bool mqttPublishDailyHistory(const ConsumptionEntry *qh, uint16_t qhCount,
-                             const struct tm &readTime)
+bool mqttPublishDailyHistory(const QhIndex &qh, const struct tm &readTime)
 {
-    // How many QH slots belong to "today" including the current in-progress slot.
-    // The newest QH entry (index 0) is the in-progress slot that the device is
-    // currently accumulating, so we add 1 to skip past it when computing day
-    // boundaries for full past days.
-    // e.g. at 14:37 → 14*4 + floor(37/15) + 1 = 59 slots assigned to today
-    int slotsIntoToday = readTime.tm_hour * 4 + readTime.tm_min / 15 + 1;
-
     int maxDays = DAILY_HISTORY_DAYS;
-    if (maxDays > 119)
-        maxDays = 119; // QH buffer = 2880 entries = 120 days max
+    // QH buffer = 2880 entries = 30 days of 96 slots; the oldest day is
+    // partial, so at most 29 whole days can be summed from it
+    constexpr int qhDays = QhRegion::words / QhRegion::entriesPerDay - 1;
+    if (maxDays > qhDays)
+        maxDays = qhDays;
 
-    JsonDocument doc;
+    JsonDocument doc(&s_jsonAllocator);
 
     char tsBuf[32];
     strftime(tsBuf, sizeof(tsBuf), "%Y-%m-%dT%H:%M:%S", &readTime);
@@ -204,69 +288,127 @@ bool mqttPublishDailyHistory(const ConsumptionEntry *qh, uint16_t qhCount,
     JsonArray days = doc["days"].to<JsonArray>();
     int count = 0;
 
-    for (int day = 0; day < maxDays; day++)
+    // Walk back one local midnight at a time. A day holds as many slots as
+    // it has quarter hours: 96, or 92/100 across a DST change.
+    // Today also takes the in-progress slot (index 0), so at 14:37 it is
+    // 14*4 + floor(37/15) + 1 = 59 slots.
+    Timeline tl;
+    timelineInit(tl, readTime);
+    time_t dayEnd = tl.at;
+    timelineStartOfDay(tl);
+    int startIdx = 0;
+
+    for (int day = 0; day < maxDays && startIdx < (int)qh.count; day++)
     {
-        int startIdx, endIdx;
-        bool complete;
+        int slots = (int)((dayEnd - tl.at) / 900) + (day == 0 ? 1 : 0);
+        int endIdx = startIdx + slots; // exclusive
+        bool complete = day > 0 && endIdx <= (int)qh.count;
 
-        if (day == 0)
-        {
-            // Today (partial): indices 0 .. slotsIntoToday-1
-            startIdx = 0;
-            endIdx = slotsIntoToday - 1;
-            complete = false;
-        }
-        else
-        {
-            // Full past day: 96 slots per day
-            startIdx = slotsIntoToday + (day - 1) * 96;
-            endIdx = startIdx + 95;
-            complete = (endIdx < qhCount);
-        }
+        JsonObject entry = days.add<JsonObject>();
+        entry["date"] = tl.date;
+        entry["litres"] = qhIndexSum(qh, startIdx, endIdx);
+        entry["complete"] = complete;
+        count++;
 
-        if (startIdx >= (int)qhCount)
-            break;
-        if (endIdx >= (int)qhCount)
-            endIdx = qhCount - 1;
+        startIdx = endIdx;
+        dayEnd = tl.at;
+        timelineStepBack(tl, 1);
+        timelineStartOfDay(tl);
+    }
 
-        uint32_t sum = 0;
-        for (int i = startIdx; i <= endIdx; i++)
-        {
-            sum += qh[i].litres;
-        }
+    doc["count"] = count;
 
-        // Compute calendar date: readTime - day days
-        struct tm dayTime = readTime;
-        dayTime.tm_mday -= day;
-        mktime(&dayTime); // normalize (handles month/year rollover)
+    size_t length;
+    bool ok = publishJson(buildTopic("daily"), doc, true, length);
+    Serial.printf("[MQTT] Daily history: %d days (%u bytes): %s\n",
+                  count, length, ok ? "OK" : "FAIL");
+    return ok;
+}
 
-        char dateBuf[16];
-        strftime(dateBuf, sizeof(dateBuf), "%Y-%m-%d", &dayTime);
+// ─── Publish Daily Totals (device daily ring) ───────────────
 
-        JsonObject entry = days.add<JsonObject>();
-        entry["date"] = dateBuf;
-        entry["litres"] = sum;
-        entry["complete"] = complete;
+// Print sink that only counts, for the length the MQTT header needs up front
+class LengthCounter : public Print
+{
+public:
+    size_t count = 0;
 
+    size_t write(uint8_t c) override
+    {
         count++;
+        return 1;
     }
 
-    doc["count"] = count;
+    size_t write(const uint8_t *data, size_t size) override
+    {
+        count += size;
+        return size;
+    }
+};
 
-    String payload;
-    serializeJson(doc, payload);
+// Write the daily totals payload entry by entry, in the same compact form
+// serializeJson() produces. Up to 1825 days never exist as a document.
+static int writeDailyTotals(Print &out, const RingView<DailyRegion> &daily,
+                            int maxDays, const char *timestamp,
+                            const struct tm &readTime)
+{
+    char buf[80];
+    snprintf(buf, sizeof(buf), "{\"timestamp\":\"%s\",\"days\":[", timestamp);
+    out.print(buf);
 
-    String topic = buildTopic("daily");
-    bool ok = s_mqtt.publish(topic.c_str(), payload.c_str(), true);
-    Serial.printf("[MQTT] Daily history: %d days (%u bytes): %s\n",
-                  count, payload.length(), ok ? "OK" : "FAIL");
+    int count = 0;
+    Timeline tl;
+    timelineInit(tl, readTime);
+
+    for (int day = 0; day < maxDays && day < (int)daily.count; day++)
+    {
+        // index 0 is today, still accumulating
+        snprintf(buf, sizeof(buf), "%s{\"date\":\"%s\",\"litres\":%u,\"complete\":%s}",
+                 day > 0 ? "," : "", tl.date, ringLitres(daily, day),
+                 day > 0 ? "true" : "false");
+        out.print(buf);
+
+        count++;
+        timelineStartOfDay(tl);
+        timelineStepBack(tl, 1); // into the previous day
+    }
+
+    snprintf(buf, sizeof(buf), "],\"count\":%d}", count);
+    out.print(buf);
+    return count;
+}
+
+bool mqttPublishDailyTotals(const RingView<DailyRegion> &daily, const struct tm &readTime)
+{
+    int maxDays = DAILY_HISTORY_DAYS;
+    if (maxDays > DailyRegion::words)
+        maxDays = DailyRegion::words; // daily buffer = 1825 entries = ~5 years
+
+    char tsBuf[32];
+    strftime(tsBuf, sizeof(tsBuf), "%Y-%m-%dT%H:%M:%S", &readTime);
+
+    // Two passes over the ring: one for the length, one into the socket
+    LengthCounter counter;
+    int count = writeDailyTotals(counter, daily, maxDays, tsBuf, readTime);
+    size_t length = counter.count;
+
+    bool ok = s_mqtt.beginPublish(buildTopic("daily"), length, true);
+    if (ok)
+    {
+        PublishWriter writer;
+        writeDailyTotals(writer, daily, maxDays, tsBuf, readTime);
+        ok = writer.drain();
+        // endPublish() must always run to leave the client's publish state
+        ok = s_mqtt.endPublish() == 1 && ok;
+    }
+    Serial.printf("[MQTT] Daily totals: %d days (%u bytes): %s\n",
+                  count, length, ok ? "OK" : "FAIL");
     return ok;
 }
 
 // ─── Publish Hourly History ─────────────────────────────────
 
-bool mqttPublishHourlyHistory(const ConsumptionEntry *qh, uint16_t qhCount,
-                              const struct tm &readTime)
+bool mqttPublishHourlyHistory(const QhIndex &qh, const struct tm &readTime)
 {
     // How many QH slots belong to the current wall-clock hour, including the
     // in-progress slot.  The newest QH entry (index 0) is the slot the device
@@ -275,10 +417,12 @@ bool mqttPublishHourlyHistory(const ConsumptionEntry *qh, uint16_t qhCount,
     int slotsIntoCurrentHour = readTime.tm_min / 15 + 1;
 
     int maxHours = HOURLY_HISTORY_HOURS;
-    if (maxHours > 719)
-        maxHours = 719; // QH = 2880 slots = 720 hours max
+    // QH = 2880 slots = 720 hours, the oldest one partial
+    constexpr int qhHours = QhRegion::words / (QhRegion::entriesPerDay / 24) - 1;
+    if (maxHours > qhHours)
+        maxHours = qhHours;
 
-    JsonDocument doc;
+    JsonDocument doc(&s_jsonAllocator);
 
     char tsBuf[32];
     strftime(tsBuf, sizeof(tsBuf), "%Y-%m-%dT%H:%M:%S", &readTime);
@@ -287,6 +431,12 @@ bool mqttPublishHourlyHistory(const ConsumptionEntry *qh, uint16_t qhCount,
     JsonArray hours = doc["hours"].to<JsonArray>();
     int count = 0;
 
+    // Hour starts are stepped back in real time, so the repeated hour of
+    // an autumn changeover appears twice and the skipped one not at all
+    Timeline tl;
+    timelineInit(tl, readTime);
+    timelineStepBack(tl, tl.secOfDay % 3600);
+
     for (int hour = 0; hour < maxHours; hour++)
     {
         int startIdx, endIdx;
@@ -304,29 +454,16 @@ bool mqttPublishHourlyHistory(const ConsumptionEntry *qh, uint16_t qhCount,
             // Full past hour: 4 QH slots each
             startIdx = slotsIntoCurrentHour + (hour - 1) * 4;
             endIdx = startIdx + 3;
-            complete = (endIdx < (int)qhCount);
+            complete = (endIdx < (int)qh.count);
         }
 
-        if (startIdx >= (int)qhCount)
+        if (startIdx >= (int)qh.count)
             break;
-        if (endIdx >= (int)qhCount)
-            endIdx = qhCount - 1;
-
-        uint32_t sum = 0;
-        for (int i = startIdx; i <= endIdx; i++)
-        {
-            sum += qh[i].litres;
-        }
-
-        // Compute hour timestamp
-        struct tm hourTime = readTime;
-        hourTime.tm_hour -= hour;
-        hourTime.tm_min = 0;
-        hourTime.tm_sec = 0;
-        mktime(&hourTime); // normalize
+        uint32_t sum = qhIndexSum(qh, startIdx, endIdx + 1);
 
-        char timeBuf[32];
-        strftime(timeBuf, sizeof(timeBuf), "%Y-%m-%dT%H:%M", &hourTime);
+        char timeBuf[17];
+        timelineFormatMinute(tl, timeBuf);
+        timelineStepBack(tl, 3600);
 
         JsonObject entry = hours.add<JsonObject>();
         entry["time"] = timeBuf;
@@ -338,13 +475,31 @@ bool mqttPublishHourlyHistory(const ConsumptionEntry *qh, uint16_t qhCount,
 
     doc["count"] = count;
 
-    String payload;
-    serializeJson(doc, payload);
-
-    String topic = buildTopic("hourly");
-    bool ok = s_mqtt.publish(topic.c_str(), payload.c_str(), true);
+    size_t length;
+    bool ok = publishJson(buildTopic("hourly"), doc, true, length);
     Serial.printf("[MQTT] Hourly history: %d hours (%u bytes): %s\n",
-                  count, payload.length(), ok ? "OK" : "FAIL");
+                  count, length, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// ─── Publish Rolling Totals ─────────────────────────────────
+
+bool mqttPublishRollingTotals(const QhIndex &qh, const struct tm &readTime)
+{
+    JsonDocument doc(&s_jsonAllocator);
+
+    char tsBuf[32];
+    strftime(tsBuf, sizeof(tsBuf), "%Y-%m-%dT%H:%M:%S", &readTime);
+    doc["timestamp"] = tsBuf;
+
+    // Completed slots only: slot 0 is still accumulating
+    doc["last_24h"] = qhIndexSum(qh, 1, 1 + QhRegion::entriesPerDay);
+    doc["last_7d"] = qhIndexSum(qh, 1, 1 + 7 * QhRegion::entriesPerDay);
+
+    size_t length;
+    bool ok = publishJson(buildTopic("rolling"), doc, true, length);
+    Serial.printf("[MQTT] Rolling totals (%u bytes): %s\n",
+                  length, ok ? "OK" : "FAIL");
     return ok;
 }
 
@@ -354,7 +509,7 @@ bool mqttPublishHADiscovery()
 {
     // Remaining litres sensor
     {
-        JsonDocument doc;
+        JsonDocument doc(&s_jsonAllocator);
         doc["name"] = "BWT Remaining Capacity";
         doc["state_topic"] = buildTopic("status");
         doc["value_template"] = "{{ value_json.remaining_litres }}";
@@ -368,15 +523,13 @@ bool mqttPublishHADiscovery()
         device["manufacturer"] = "BWT";
         device["model"] = "Perla";
 
-        String payload;
-        serializeJson(doc, payload);
-        s_mqtt.publish("homeassistant/sensor/bwt_water_remaining/config",
-                       payload.c_str(), true);
+        size_t length;
+        publishJson("homeassistant/sensor/bwt_water_remaining/config", doc, true, length);
     }
 
     // Percentage sensor
     {
-        JsonDocument doc;
+        JsonDocument doc(&s_jsonAllocator);
         doc["name"] = "BWT Capacity Percentage";
         doc["state_topic"] = buildTopic("status");
         doc["value_template"] = "{{ (value_json.percentage * 100) | round(1) }}";
@@ -389,15 +542,13 @@ bool mqttPublishHADiscovery()
         device["manufacturer"] = "BWT";
         device["model"] = "Perla";
 
-        String payload;
-        serializeJson(doc, payload);
-        s_mqtt.publish("homeassistant/sensor/bwt_water_percentage/config",
-                       payload.c_str(), true);
+        size_t length;
+        publishJson("homeassistant/sensor/bwt_water_percentage/config", doc, true, length);
     }
 
     // Alarm binary sensor
     {
-        JsonDocument doc;
+        JsonDocument doc(&s_jsonAllocator);
         doc["name"] = "BWT Alarm";
         doc["state_topic"] = buildTopic("status");
         doc["value_template"] = "{{ 'ON' if value_json.alarm else 'OFF' }}";
@@ -410,15 +561,13 @@ bool mqttPublishHADiscovery()
         device["manufacturer"] = "BWT";
         device["model"] = "Perla";
 
-        String payload;
-        serializeJson(doc, payload);
-        s_mqtt.publish("homeassistant/binary_sensor/bwt_water_alarm/config",
-                       payload.c_str(), true);
+        size_t length;
+        publishJson("homeassistant/binary_sensor/bwt_water_alarm/config", doc, true, length);
     }
 
     // Regen counter sensor
     {
-        JsonDocument doc;
+        JsonDocument doc(&s_jsonAllocator);
         doc["name"] = "BWT Regen Count";
         doc["state_topic"] = buildTopic("status");
         doc["value_template"] = "{{ value_json.regen_count }}";
@@ -431,15 +580,13 @@ bool mqttPublishHADiscovery()
         device["manufacturer"] = "BWT";
         device["model"] = "Perla";
 
-        String payload;
-        serializeJson(doc, payload);
-        s_mqtt.publish("homeassistant/sensor/bwt_water_regen/config",
-                       payload.c_str(), true);
+        size_t length;
+        publishJson("homeassistant/sensor/bwt_water_regen/config", doc, true, length);
     }
 
     // Meter sensor (last 15-min consumption)
     {
-        JsonDocument doc;
+        JsonDocument doc(&s_jsonAllocator);
         doc["name"] = "BWT 15min Consumption";
         doc["state_topic"] = buildTopic("meter");
         doc["unit_of_measurement"] = "L";
@@ -454,10 +601,48 @@ bool mqttPublishHADiscovery()
         device["manufacturer"] = "BWT";
         device["model"] = "Perla";
 
-        String payload;
-        serializeJson(doc, payload);
-        s_mqtt.publish("homeassistant/sensor/bwt_water_meter_15min/config",
-                       payload.c_str(), true);
+        size_t length;
+        publishJson("homeassistant/sensor/bwt_water_meter_15min/config", doc, true, length);
+    }
+
+    // Rolling 24 h / 7 d totals
+    {
+        JsonDocument doc(&s_jsonAllocator);
+        doc["name"] = "BWT Last 24h Consumption";
+        doc["state_topic"] = buildTopic("rolling");
+        doc["value_template"] = "{{ value_json.last_24h }}";
+        doc["unit_of_measurement"] = "L";
+        doc["device_class"] = "water";
+        doc["state_class"] = "measurement";
+        doc["unique_id"] = "bwt_water_last_24h";
+
+        JsonObject device = doc["device"].to<JsonObject>();
+        device["identifiers"][0] = "bwt_water_meter";
+        device["name"] = "BWT Water Meter";
+        device["manufacturer"] = "BWT";
+        device["model"] = "Perla";
+
+        size_t length;
+        publishJson("homeassistant/sensor/bwt_water_last_24h/config", doc, true, length);
+    }
+    {
+        JsonDocument doc(&s_jsonAllocator);
+        doc["name"] = "BWT Last 7d Consumption";
+        doc["state_topic"] = buildTopic("rolling");
+        doc["value_template"] = "{{ value_json.last_7d }}";
+        doc["unit_of_measurement"] = "L";
+        doc["device_class"] = "water";
+        doc["state_class"] = "measurement";
+        doc["unique_id"] = "bwt_water_last_7d";
+
+        JsonObject device = doc["device"].to<JsonObject>();
+        device["identifiers"][0] = "bwt_water_meter";
+        device["name"] = "BWT Water Meter";
+        device["manufacturer"] = "BWT";
+        device["model"] = "Perla";
+
+        size_t length;
+        publishJson("homeassistant/sensor/bwt_water_last_7d/config", doc, true, length);
     }
 
     Serial.println("[MQTT] HA Discovery messages published");
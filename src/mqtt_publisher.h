@@ -1,9 +1,20 @@
 #pragma once
 
 #include "bwt_protocol.h"
+#include "ble_client.h"
+#include "qh_index.h"
+#include "ring_view.h"
+#include "poll_arena.h"
 #include <stdint.h>
 #include <time.h>
 
+/**
+ * Build JSON payloads in `arena` instead of on the heap (nullptr: heap).
+ * Documents are released when each publish returns, but the memory only
+ * comes back with the owner's arenaReset().
+ */
+void mqttUseArena(PollArena *arena);
+
 /**
  * Initialize MQTT client (set server, buffer size, etc).
  * Call once in setup() after WiFi is connected.
@@ -21,19 +32,6 @@ bool mqttConnect();
  */
 void mqttDisconnect();
 
-/**
- * Force disconnect and reconnect MQTT with a fresh TCP socket.
- * Use after BLE session when the TCP connection may be stale.
- * Returns true if reconnected successfully.
- */
-bool mqttForceReconnect();
-
-/**
- * Verify WiFi + MQTT are both up; reconnect if needed.
- * Returns true if MQTT is connected and ready.
- */
-bool mqttEnsureConnected();
-
 /**
  * Call in loop() to process MQTT keep-alive.
  */
@@ -59,22 +57,57 @@ bool mqttPublishMeter(uint16_t litres);
 /**
  * Publish daily consumption history with dates.
  * Computed by summing QH entries per calendar day (excluding regen slots).
- * qhEntries must be in newest-first order.
+ * `qh` indexes newest-first QH entries.
+ *
+ * Topic: bwt/water/daily  (retained, single JSON message)
+ */
+bool mqttPublishDailyHistory(const QhIndex &qh, const struct tm &readTime);
+
+/**
+ * Publish daily consumption history from the device's own daily ring
+ * (10 L resolution, up to ~5 years). Same payload as mqttPublishDailyHistory,
+ * written straight into the publish without building a JSON document.
+ * The newest entry of `daily` is today (still in progress).
  *
  * Topic: bwt/water/daily  (retained, single JSON message)
  */
-bool mqttPublishDailyHistory(const ConsumptionEntry *qhEntries, uint16_t qhCount,
-                             const struct tm &readTime);
+bool mqttPublishDailyTotals(const RingView<DailyRegion> &daily, const struct tm &readTime);
 
 /**
  * Publish hourly consumption history with timestamps.
  * Computed by summing 4 consecutive QH entries per wall-clock hour.
- * qhEntries must be in newest-first order.
+ * `qh` indexes newest-first QH entries.
  *
  * Topic: bwt/water/hourly  (retained, single JSON message)
  */
-bool mqttPublishHourlyHistory(const ConsumptionEntry *qhEntries, uint16_t qhCount,
-                              const struct tm &readTime);
+bool mqttPublishHourlyHistory(const QhIndex &qh, const struct tm &readTime);
+
+/**
+ * Publish rolling totals over the last 24 hours and 7 days of completed
+ * QH slots (the in-progress slot is left out).
+ *
+ * Topic: bwt/water/rolling  (retained, JSON)
+ */
+bool mqttPublishRollingTotals(const QhIndex &qh, const struct tm &readTime);
+
+/**
+ * Per-cycle counters for comparing radio sharing modes.
+ */
+struct CycleDiagnostics
+{
+    uint32_t cycle;
+    bool coexist;              // WIFI_BLE_COEXIST was on
+    unsigned long bleMs;       // BLE connect to disconnect
+    unsigned long reconnectMs; // WiFi + NTP + MQTT back up after BLE (0 if never down)
+    unsigned long publishMs;   // previous cycle's publish time
+    BleLinkStats link;
+};
+
+/**
+ * Publish radio/link diagnostics for one poll cycle.
+ * Topic: bwt/water/diag  (not retained, JSON)
+ */
+bool mqttPublishDiagnostics(const CycleDiagnostics &diag);
 
 /**
  * Publish Home Assistant auto-discovery config messages.
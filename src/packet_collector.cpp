@@ -4,45 +4,122 @@
 #include <Arduino.h>
 #include <string.h>
 
-bool collectorInit(PacketCollector &col, uint16_t expectedBytes)
+static inline bool hasPacket(const PacketCollector &col, uint16_t idx)
+{
+    return (col.received[idx >> 3] & (1 << (idx & 7))) != 0;
+}
+
+bool collectorInit(PacketCollector &col, uint16_t expectedBytes, PollArena &arena)
 {
     col.expectedBytes = expectedBytes;
     col.expectedPackets = (expectedBytes + PACKET_DATA - 1) / PACKET_DATA; // ceil
     col.receivedPackets = 0;
     col.lastSeenIndex = 0;
     col.missedPackets = 0;
+    col.reorderedPackets = 0;
+    col.duplicatePackets = 0;
     col.bufferLen = 0;
+    col.lastPacketAt = millis();
     col.complete = false;
     col.error = false;
+    col.received = nullptr;
+    collectorBeginRange(col, 0, col.expectedPackets);
 
-    col.buffer = (uint8_t *)malloc(expectedBytes);
+    col.buffer = (uint8_t *)arenaAlloc(arena, expectedBytes);
     if (!col.buffer)
     {
-        Serial.println("[Collector] malloc failed!");
+        Serial.println("[Collector] Allocation failed!");
         col.error = true;
         return false;
     }
     memset(col.buffer, 0, expectedBytes);
-    return true;
-}
 
-void collectorFree(PacketCollector &col)
-{
-    if (col.buffer)
+    uint16_t bitmapLen = (col.expectedPackets + 7) / 8;
+    col.received = (uint8_t *)arenaAlloc(arena, bitmapLen);
+    if (!col.received)
     {
-        free(col.buffer);
+        Serial.println("[Collector] Allocation failed!");
+        arenaFree(arena, col.buffer);
         col.buffer = nullptr;
+        col.error = true;
+        return false;
     }
+    memset(col.received, 0, bitmapLen);
+    return true;
+}
+
+void collectorFree(PacketCollector &col, PollArena &arena)
+{
+    arenaFree(arena, col.buffer);
+    col.buffer = nullptr;
+    arenaFree(arena, col.received);
+    col.received = nullptr;
     col.expectedBytes = 0;
     col.expectedPackets = 0;
     col.receivedPackets = 0;
     col.lastSeenIndex = 0;
     col.missedPackets = 0;
+    col.reorderedPackets = 0;
+    col.duplicatePackets = 0;
     col.bufferLen = 0;
+    col.rangeFirst = 0;
+    col.rangeCount = 0;
+    col.rangeReceived = 0;
+    col.tailSeen = false;
+    col.streamDone = false;
     col.complete = false;
     col.error = false;
 }
 
+void collectorBeginRange(PacketCollector &col, uint16_t first, uint16_t count)
+{
+    col.rangeFirst = first;
+    col.rangeCount = count;
+    col.rangeReceived = 0;
+    col.lastSeenIndex = 0;
+    col.lastPacketAt = millis();
+    col.tailSeen = false;
+    col.streamDone = false;
+}
+
+bool collectorNextGap(const PacketCollector &col, uint16_t from,
+                      uint16_t &first, uint16_t &count)
+{
+    uint16_t i = from;
+    while (i < col.expectedPackets && hasPacket(col, i))
+        i++;
+    if (i >= col.expectedPackets)
+        return false;
+
+    first = i;
+    while (i < col.expectedPackets && !hasPacket(col, i))
+        i++;
+    count = i - first;
+    return true;
+}
+
+uint16_t collectorMissingCount(const PacketCollector &col)
+{
+    return col.expectedPackets - col.receivedPackets;
+}
+
+uint16_t collectorMissing(const PacketCollector &col, uint16_t *out, uint16_t maxOut)
+{
+    uint16_t n = 0;
+    for (uint16_t i = 0; i < col.expectedPackets && n < maxOut; i++)
+    {
+        // Skip whole bytes of the bitmap that are fully received
+        if ((i & 7) == 0 && col.received[i >> 3] == 0xFF && i + 8 <= col.expectedPackets)
+        {
+            i += 7;
+            continue;
+        }
+        if (!hasPacket(col, i))
+            out[n++] = i;
+    }
+    return n;
+}
+
 void collectorOnPacket(PacketCollector &col, const uint8_t *data, uint16_t len)
 {
     if (col.complete || col.error)
@@ -55,39 +132,54 @@ void collectorOnPacket(PacketCollector &col, const uint8_t *data, uint16_t len)
         return;
     }
 
-    // Extract packet index from the 2-byte header
+    // Extract packet index from the 2-byte header (relative to the request)
     uint16_t pktIndex = readUint16LE(data, 0);
 
-    // Check for duplicate or backwards jump
-    if (col.receivedPackets > 0 && pktIndex < col.lastSeenIndex)
+    // Outside the current request: most likely a straggler from an earlier
+    // request that was cut short, so its index can't be mapped safely
+    if (pktIndex >= col.rangeCount)
     {
-        Serial.printf("[Collector] Duplicate/backwards: got %u, last was %u (ignoring)\n",
-                      pktIndex, col.lastSeenIndex);
-        return; // ignore but don't error
+        Serial.printf("[Collector] Packet index %u outside request of %u (ignoring)\n",
+                      pktIndex, col.rangeCount);
+        return;
     }
 
-    // Detect gaps (missed packets)
-    uint16_t expectedNext = col.receivedPackets > 0 ? col.lastSeenIndex + 1 : 0;
-    if (pktIndex > expectedNext)
+    uint16_t absIndex = col.rangeFirst + pktIndex;
+    col.lastPacketAt = millis();
+    if (pktIndex == col.rangeCount - 1)
+        col.tailSeen = true;
+
+    // O(1) duplicate check against the received bitmap
+    if (hasPacket(col, absIndex))
     {
-        uint16_t gap = pktIndex - expectedNext;
-        col.missedPackets += gap;
-        Serial.printf("[Collector] Gap detected: expected %u, got %u (missed %u packets, total missed: %u)\n",
-                      expectedNext, pktIndex, gap, col.missedPackets);
+        col.duplicatePackets++;
+        return;
     }
 
-    // Check we don't exceed expected count
-    if (pktIndex >= col.expectedPackets)
+    if (col.rangeReceived == 0 || pktIndex > col.lastSeenIndex)
     {
-        Serial.printf("[Collector] Packet index %u exceeds expected count %u\n",
-                      pktIndex, col.expectedPackets);
-        col.error = true;
-        return;
+        // Detect gaps (packets skipped over, may still arrive late)
+        uint16_t expectedNext = col.rangeReceived > 0 ? col.lastSeenIndex + 1 : 0;
+        if (pktIndex > expectedNext)
+        {
+            uint16_t gap = pktIndex - expectedNext;
+            col.missedPackets += gap;
+            Serial.printf("[Collector] Gap detected: expected %u, got %u (missed %u packets, total missed: %u)\n",
+                          expectedNext, pktIndex, gap, col.missedPackets);
+        }
+        col.lastSeenIndex = pktIndex;
+    }
+    else
+    {
+        // Late first delivery of a packet counted as missed above
+        col.reorderedPackets++;
+        if (col.missedPackets > 0)
+            col.missedPackets--;
     }
 
     // Copy data portion at the correct offset based on packet index
     uint16_t dataLen = len - PACKET_HEADER;
-    uint16_t offset = pktIndex * PACKET_DATA;
+    uint16_t offset = absIndex * PACKET_DATA;
 
     // Don't overflow the buffer
     if (offset + dataLen > col.expectedBytes)
@@ -96,23 +188,20 @@ void collectorOnPacket(PacketCollector &col, const uint8_t *data, uint16_t len)
     }
 
     memcpy(col.buffer + offset, data + PACKET_HEADER, dataLen);
+    col.received[absIndex >> 3] |= (1 << (absIndex & 7));
     col.bufferLen += dataLen;
     col.receivedPackets++;
-    col.lastSeenIndex = pktIndex;
+    col.rangeReceived++;
 
-    // Check completion: received all packets or reached last expected index
-    if (pktIndex == col.expectedPackets - 1)
+    if (col.rangeReceived == col.rangeCount)
+        col.streamDone = true;
+
+    // Check completion: every packet of the dataset is present
+    if (col.receivedPackets == col.expectedPackets)
     {
         col.complete = true;
-        if (col.missedPackets > 0)
-        {
-            Serial.printf("[Collector] Complete with gaps: %u/%u packets received, %u missed (zeroed)\n",
-                          col.receivedPackets, col.expectedPackets, col.missedPackets);
-        }
-        else
-        {
-            Serial.printf("[Collector] Complete: %u packets, %u bytes\n",
-                          col.receivedPackets, col.bufferLen);
-        }
+        Serial.printf("[Collector] Complete: %u packets, %u bytes (%u reordered, %u duplicates)\n",
+                      col.receivedPackets, col.bufferLen,
+                      col.reorderedPackets, col.duplicatePackets);
     }
 }
@@ -1,33 +1,70 @@
 #pragma once
 
 #include <stdint.h>
+#include "poll_arena.h"
 
 struct PacketCollector
 {
     uint16_t expectedPackets; // ceil(expectedBytes / 18)
     uint16_t expectedBytes;   // total bytes to receive
-    uint16_t receivedPackets; // counter
-    uint16_t lastSeenIndex;   // highest packet index seen
-    uint16_t missedPackets;   // count of gaps detected
-    uint8_t *buffer;          // raw concatenated data (allocated dynamically)
+    uint16_t receivedPackets; // distinct packets stored so far
+    uint16_t lastSeenIndex;   // highest packet index seen in the current request
+    uint16_t missedPackets;   // packets skipped over and not (yet) filled in
+    uint16_t reorderedPackets; // packets that arrived after a higher index
+    uint16_t duplicatePackets; // packets already present in the bitmap
+    uint8_t *buffer;          // raw concatenated data (from the arena)
+    uint8_t *received;        // bitmap of stored packet indices (from the arena)
     uint16_t bufferLen;       // actual bytes written to buffer
+    uint16_t rangeFirst;      // dataset packet index of the current request's packet 0
+    uint16_t rangeCount;      // packets in the current request
+    uint16_t rangeReceived;   // packets received for the current request
+    unsigned long lastPacketAt; // millis() of the last accepted packet
+    bool tailSeen;            // final index of the current request arrived
+    bool streamDone;          // every packet of the current request present
     bool complete;            // all packets received
     bool error;               // overflow or critical error
 };
 
 /**
  * Initialize (reset) a packet collector for a new fetch.
- * Allocates the internal buffer. Returns true on success.
+ * Allocates the internal buffer from `arena`. Returns true on success.
+ * The whole dataset is the current request until collectorBeginRange().
  */
-bool collectorInit(PacketCollector &col, uint16_t expectedBytes);
+bool collectorInit(PacketCollector &col, uint16_t expectedBytes, PollArena &arena);
 
 /**
- * Free the collector's internal buffer.
+ * Release the collector's internal buffer back to `arena`.
  */
-void collectorFree(PacketCollector &col);
+void collectorFree(PacketCollector &col, PollArena &arena);
+
+/**
+ * Start a follow-up request covering packets [first, first + count) of the
+ * dataset. The device numbers the packets of every response from 0, so
+ * incoming indices are offset by `first`.
+ */
+void collectorBeginRange(PacketCollector &col, uint16_t first, uint16_t count);
+
+/**
+ * Find the next run of packets not yet received, starting at index `from`.
+ * Returns false if every packet from `from` onwards is present.
+ */
+bool collectorNextGap(const PacketCollector &col, uint16_t from,
+                      uint16_t &first, uint16_t &count);
+
+/**
+ * Number of dataset packets not yet received.
+ */
+uint16_t collectorMissingCount(const PacketCollector &col);
+
+/**
+ * Write up to `maxOut` missing packet indices (ascending) into `out`.
+ * Returns the number written.
+ */
+uint16_t collectorMissing(const PacketCollector &col, uint16_t *out, uint16_t maxOut);
 
 /**
  * Process an incoming notification packet.
  * data/len come from the BLE notification callback.
+ * Packets may arrive in any order; duplicates are dropped via the bitmap.
  */
 void collectorOnPacket(PacketCollector &col, const uint8_t *data, uint16_t len);
@@ -0,0 +1,115 @@
+#include "poll_arena.h"
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_ALIGN 8
+
+// Every block is preceded by its size, so a block that is not the most
+// recent one can still be copied on reallocate
+struct ArenaHeader
+{
+    uint32_t size;
+    uint32_t reserved; // keeps the payload 8-byte aligned
+};
+
+static_assert(sizeof(ArenaHeader) % ARENA_ALIGN == 0, "arena header breaks alignment");
+
+// ─── Helpers ────────────────────────────────────────────────
+
+static inline size_t alignUp(size_t n)
+{
+    return (n + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+static inline bool inArena(const PollArena &a, const void *ptr)
+{
+    const uint8_t *p = (const uint8_t *)ptr;
+    return p >= a.base && p < a.base + a.size;
+}
+
+static inline ArenaHeader *headerOf(void *ptr)
+{
+    return (ArenaHeader *)ptr - 1;
+}
+
+// ─── Public Functions ───────────────────────────────────────
+
+void arenaInit(PollArena &a, uint8_t *storage, size_t size)
+{
+    // The storage itself may not be aligned; skip to the first boundary
+    size_t skew = alignUp((uintptr_t)storage) - (uintptr_t)storage;
+    a.base = storage + skew;
+    a.size = size > skew ? (size - skew) & ~(size_t)(ARENA_ALIGN - 1) : 0;
+    a.used = 0;
+    a.peak = 0;
+    a.last = nullptr;
+    a.overflows = 0;
+}
+
+void *arenaAlloc(PollArena &a, size_t size)
+{
+    size_t need = sizeof(ArenaHeader) + alignUp(size);
+    if (need > a.size - a.used)
+    {
+        a.overflows++;
+        return malloc(size);
+    }
+
+    ArenaHeader *h = (ArenaHeader *)(a.base + a.used);
+    h->size = size;
+    a.used += need;
+    if (a.used > a.peak)
+        a.peak = a.used;
+    a.last = h + 1;
+    return a.last;
+}
+
+void *arenaRealloc(PollArena &a, void *ptr, size_t size)
+{
+    if (!ptr)
+        return arenaAlloc(a, size);
+    if (!inArena(a, ptr))
+        return realloc(ptr, size);
+
+    ArenaHeader *h = headerOf(ptr);
+    if (ptr == a.last)
+    {
+        // Top of the arena: move the cursor instead of copying
+        size_t start = (uint8_t *)ptr - a.base;
+        size_t need = alignUp(size);
+        if (need <= a.size - start)
+        {
+            h->size = size;
+            a.used = start + need;
+            if (a.used > a.peak)
+                a.peak = a.used;
+            return ptr;
+        }
+    }
+
+    void *moved = arenaAlloc(a, size);
+    if (moved)
+        memcpy(moved, ptr, h->size < size ? h->size : size);
+    return moved;
+}
+
+void arenaFree(PollArena &a, void *ptr)
+{
+    if (ptr && !inArena(a, ptr))
+        free(ptr);
+}
+
+void arenaReset(PollArena &a, const char *label)
+{
+    Serial.printf("[Arena] %s: %u of %u bytes used (peak %u)",
+                  label, (unsigned)a.used, (unsigned)a.size, (unsigned)a.peak);
+    if (a.overflows > 0)
+        Serial.printf(", %u allocations spilled to the heap", a.overflows);
+    Serial.println();
+
+    a.used = 0;
+    a.last = nullptr;
+    a.overflows = 0;
+}
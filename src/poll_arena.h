@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Bump allocator over a statically reserved block, for memory that only
+ * lives for one poll cycle. Allocation moves a cursor; nothing is returned
+ * to the arena until arenaReset() at the end of the cycle, so the heap
+ * never sees the per-cycle churn and cannot fragment from it.
+ * Each task uses its own arena; an arena is not thread-safe.
+ *
+ * If a cycle needs more than the arena holds, the excess comes from the
+ * heap (counted in `overflows`) rather than failing the publish.
+ */
+struct PollArena
+{
+    uint8_t *base;
+    size_t size;
+    size_t used;        // bytes handed out since the last reset
+    size_t peak;        // highest `used` since boot
+    void *last;         // most recent block, which can still grow in place
+    uint16_t overflows; // allocations served by the heap since the last reset
+};
+
+/**
+ * Set up an arena over caller-owned `storage` of `size` bytes.
+ */
+void arenaInit(PollArena &a, uint8_t *storage, size_t size);
+
+/**
+ * `size` bytes, 8-byte aligned. Falls back to the heap when the arena is
+ * full; returns nullptr only if that fails too.
+ */
+void *arenaAlloc(PollArena &a, size_t size);
+
+/**
+ * Resize a block from arenaAlloc(). The most recent arena block grows or
+ * shrinks in place; any other is copied to a new block.
+ */
+void *arenaRealloc(PollArena &a, void *ptr, size_t size);
+
+/**
+ * Release a block. Arena memory only comes back on arenaReset(); heap
+ * fallbacks are freed right away.
+ */
+void arenaFree(PollArena &a, void *ptr);
+
+/**
+ * Reclaim the whole arena for the next cycle and log its usage under
+ * `label`. Every arena block handed out before is invalid afterwards.
+ */
+void arenaReset(PollArena &a, const char *label);
@@ -0,0 +1,140 @@
+#include "poll_scheduler.h"
+#include "config.h"
+#include "bwt_regions.h"
+
+#include <Arduino.h>
+#include <string.h>
+
+#define SCHED_SLOT_S ((int)(QhRegion::slotMs / 1000)) // device QH slot length
+
+// Never start polls closer together than this
+#define SCHED_MIN_GAP_S 30
+
+// ─── Module State ───────────────────────────────────────────
+// RTC memory: the estimate carries over deep sleep between polls
+
+// Bit p set: the device may advance its QH index at epoch % 900 == p.
+// Every pair of reads less than a slot apart rules out part of the range.
+RTC_DATA_ATTR static uint8_t s_candidates[(SCHED_SLOT_S + 7) / 8];
+RTC_DATA_ATTR static bool s_candidatesInit = false;
+RTC_DATA_ATTR static bool s_havePrev = false;
+RTC_DATA_ATTR static time_t s_prevAt = 0;
+RTC_DATA_ATTR static uint16_t s_prevIdx = 0;
+
+// ─── Helpers ────────────────────────────────────────────────
+
+static inline bool isCandidate(uint16_t p)
+{
+    return (s_candidates[p >> 3] & (1 << (p & 7))) != 0;
+}
+
+static void resetCandidates()
+{
+    memset(s_candidates, 0xFF, sizeof(s_candidates));
+    s_candidatesInit = true;
+}
+
+static uint16_t candidateCount()
+{
+    uint16_t n = 0;
+    for (uint16_t p = 0; p < SCHED_SLOT_S; p++)
+        n += isCandidate(p);
+    return n;
+}
+
+// Keep (inside = true) or drop (false) the phases in (from, from + len]
+static void applyArc(uint16_t from, uint16_t len, bool inside)
+{
+    for (uint16_t p = 0; p < SCHED_SLOT_S; p++)
+    {
+        uint16_t d = (p + SCHED_SLOT_S - from) % SCHED_SLOT_S;
+        bool inArc = d > 0 && d <= len;
+        if (inArc != inside)
+            s_candidates[p >> 3] &= ~(1 << (p & 7));
+    }
+}
+
+// Candidate range as a circular arc [first, first + width)
+static void candidateArc(uint16_t &first, uint16_t &width)
+{
+    first = 0;
+    width = 0;
+    for (uint16_t p = 0; p < SCHED_SLOT_S; p++)
+    {
+        uint16_t prev = (p + SCHED_SLOT_S - 1) % SCHED_SLOT_S;
+        if (isCandidate(p) && !isCandidate(prev))
+        {
+            first = p;
+            break;
+        }
+    }
+    while (width < SCHED_SLOT_S && isCandidate((first + width) % SCHED_SLOT_S))
+        width++;
+}
+
+// ─── Public Functions ───────────────────────────────────────
+
+void schedObserve(time_t readAt, uint16_t qhIdx)
+{
+    if (readAt == 0)
+        return;
+    if (!s_candidatesInit)
+        resetCandidates();
+
+    if (s_havePrev && readAt > s_prevAt && readAt - s_prevAt < SCHED_SLOT_S)
+    {
+        uint16_t advanced = (qhIdx + QhRegion::words - s_prevIdx) % QhRegion::words;
+        uint16_t from = s_prevAt % SCHED_SLOT_S;
+        uint16_t len = readAt - s_prevAt;
+
+        if (advanced <= 1)
+        {
+            uint8_t saved[sizeof(s_candidates)];
+            memcpy(saved, s_candidates, sizeof(saved));
+            applyArc(from, len, advanced == 1);
+            if (candidateCount() == 0)
+            {
+                // Device clock drifted against ours (or was reset): relearn
+                Serial.println("[Sched] Slot boundary moved, relearning");
+                resetCandidates();
+                applyArc(from, len, advanced == 1);
+            }
+        }
+        else
+        {
+            // More than one boundary in under a slot: device reset or reconfigured
+            resetCandidates();
+        }
+
+        uint16_t first, width;
+        candidateArc(first, width);
+        Serial.printf("[Sched] QH boundary %u:%02u past the quarter hour (window %u s)\n",
+                      first / 60, first % 60, width);
+    }
+
+    s_havePrev = true;
+    s_prevAt = readAt;
+    s_prevIdx = qhIdx;
+}
+
+uint32_t schedNextPollDelayMs(time_t now, unsigned long sinceLastStartMs)
+{
+    if (!POLL_ALIGN_TO_SLOTS || now == 0 || !s_candidatesInit)
+        return sinceLastStartMs < POLL_INTERVAL_MS ? POLL_INTERVAL_MS - sinceLastStartMs : 0;
+
+    uint16_t first, width;
+    candidateArc(first, width);
+
+    uint16_t target;
+    if (width >= SCHED_SLOT_S)
+        target = (now + SCHED_SLOT_S / 2) % SCHED_SLOT_S; // nothing learnt yet
+    else if (width > POLL_PROBE_WIDTH_S)
+        target = (first + width / 2) % SCHED_SLOT_S; // split the range
+    else
+        target = (first + width - 1 + POLL_SLOT_MARGIN_S) % SCHED_SLOT_S;
+
+    time_t at = now - now % SCHED_SLOT_S + target;
+    while (at < now + SCHED_MIN_GAP_S)
+        at += SCHED_SLOT_S;
+    return (uint32_t)(at - now) * 1000;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * Record a broadcast read: wall-clock time and the QH write index.
+ * Consecutive reads less than a slot apart tell whether a slot boundary
+ * fell between them, which narrows down the boundary's offset within the
+ * wall-clock quarter hour. `readAt` comes from timeNow(); reads without a
+ * valid clock (0) are ignored.
+ */
+void schedObserve(time_t readAt, uint16_t qhIdx);
+
+/**
+ * Milliseconds until the next poll should start, measured from `now`
+ * (timeNow(), 0 if the clock is not set).
+ * Normally the boundary estimate is tight and this is just after the
+ * next boundary (+POLL_SLOT_MARGIN_S). While it is still wider than
+ * POLL_PROBE_WIDTH_S, it returns a probe time in the middle of the
+ * remaining range instead. Without a valid clock, returns
+ * POLL_INTERVAL_MS measured from the last poll start.
+ */
+uint32_t schedNextPollDelayMs(time_t now, unsigned long sinceLastStartMs);
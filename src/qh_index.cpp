@@ -0,0 +1,47 @@
+#include "qh_index.h"
+
+// Words batch-decoded per step while building the sums
+#define QH_INDEX_CHUNK 64
+
+bool qhIndexBuild(QhIndex &index, const RingView<QhRegion> &qh, PollArena &arena)
+{
+    uint16_t count = qh.count;
+    index.count = 0;
+    index.sums = (uint32_t *)arenaAlloc(arena, ((size_t)count + 1) * sizeof(uint32_t));
+    if (!index.sums)
+        return false;
+
+    uint16_t litres[QH_INDEX_CHUNK];
+    uint32_t total = 0;
+    index.sums[0] = 0;
+    for (uint16_t i = 0; i < count;)
+    {
+        // The run comes back oldest first; the sums go newest first
+        uint16_t n = ringLitresRun(qh, i, QH_INDEX_CHUNK, litres);
+        for (uint16_t j = n; j-- > 0;)
+        {
+            total += litres[j];
+            index.sums[++i] = total;
+        }
+    }
+    index.count = count;
+    return true;
+}
+
+void qhIndexFree(QhIndex &index, PollArena &arena)
+{
+    arenaFree(arena, index.sums);
+    index.sums = nullptr;
+    index.count = 0;
+}
+
+uint32_t qhIndexSum(const QhIndex &index, int start, int end)
+{
+    if (start < 0)
+        start = 0;
+    if (end > (int)index.count)
+        end = index.count;
+    if (!index.sums || start >= end)
+        return 0;
+    return index.sums[end] - index.sums[start];
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+#include "ring_view.h"
+#include "poll_arena.h"
+
+/**
+ * Prefix sums over the QH ring in newest-first order, built once per poll so every
+ * window sum (hours, days, rolling totals) is O(1) and shares one pass.
+ * sums[i] is the total of entries [0, i); index 0 is the in-progress slot.
+ */
+struct QhIndex
+{
+    uint32_t *sums; // count + 1 values, from the poll arena
+    uint16_t count; // entries indexed
+};
+
+/**
+ * Build the index over the QH ring, newest entry first, with the sums
+ * taken from `arena`. Returns false (index left empty) if the allocation
+ * failed.
+ */
+bool qhIndexBuild(QhIndex &index, const RingView<QhRegion> &qh, PollArena &arena);
+
+/**
+ * Release the sums back to `arena`; the index is empty afterwards.
+ */
+void qhIndexFree(QhIndex &index, PollArena &arena);
+
+/**
+ * Total litres of slots [start, end). The range is clipped to the indexed
+ * slots, so a window reaching past the oldest one sums what is there.
+ */
+uint32_t qhIndexSum(const QhIndex &index, int start, int end);
@@ -0,0 +1,166 @@
+#include "ring_mirror.h"
+#include "time_sync.h"
+#include <Arduino.h>
+#include <string.h>
+
+void mirrorInit(RingMirror &m, uint16_t startAddr, uint16_t regionSize,
+                uint32_t slotPeriodMs, uint8_t *storage)
+{
+    m.startAddr = startAddr;
+    m.regionSize = regionSize;
+    m.slotPeriodMs = slotPeriodMs;
+    m.data = storage;
+    memset(m.data, 0, regionSize);
+    if (mirrorPageCount(m) > MIRROR_MAX_PAGES)
+    {
+        Serial.printf("[Mirror] Region of %u bytes exceeds dirty-page tracking\n",
+                      regionSize);
+    }
+    mirrorInvalidate(m);
+    m.dirtyPages = 0;
+}
+
+void mirrorInvalidate(RingMirror &m)
+{
+    m.idx = 0;
+    m.looped = false;
+    m.valid = false;
+    m.syncedAt = 0;
+    m.syncedEpoch = 0;
+    m.metaDirty = true;
+}
+
+// Full-region plan, the same request the app makes: the written part
+// until the ring has looped, then all of it
+static uint8_t planFull(const RingMirror &m, uint16_t newIdx, bool newLooped,
+                        FetchRange *ranges)
+{
+    uint16_t size = newLooped ? m.regionSize : 2 * newIdx;
+    if (size == 0)
+        return 0;
+    ranges[0].address = m.startAddr;
+    ranges[0].size = size;
+    return 1;
+}
+
+uint8_t mirrorPlanFetch(const RingMirror &m, uint16_t newIdx, bool newLooped,
+                        FetchRange *ranges)
+{
+    uint16_t words = m.regionSize / 2;
+
+    if (newIdx >= words)
+    {
+        Serial.printf("[Mirror] Write index %u out of range (%u words)\n", newIdx, words);
+        return MIRROR_PLAN_INVALID;
+    }
+
+    if (!m.valid)
+        return planFull(m, newIdx, newLooped, ranges);
+
+    // Device ring was reset (looped flag cleared or index went backwards)
+    if ((m.looped && !newLooped) || (!newLooped && newIdx < m.idx))
+    {
+        Serial.printf("[Mirror] Ring reset detected (idx %u -> %u, looped %d -> %d)\n",
+                      m.idx, newIdx, m.looped, newLooped);
+        return planFull(m, newIdx, newLooped, ranges);
+    }
+
+    // Offline long enough that the write index may have lapped the mirror.
+    // Prefer wall-clock time: millis() restarts when the mirror is reloaded
+    // from flash after a reboot.
+    uint32_t elapsedSlots = (millis() - m.syncedAt) / m.slotPeriodMs;
+    time_t now = timeNow();
+    if (m.syncedEpoch != 0 && now != 0)
+    {
+        uint32_t elapsedSec = now > (time_t)m.syncedEpoch ? (uint32_t)(now - m.syncedEpoch) : 0;
+        elapsedSlots = elapsedSec / (m.slotPeriodMs / 1000);
+    }
+    if (elapsedSlots + 1 >= words)
+    {
+        Serial.printf("[Mirror] Last sync %lu slots ago, refetching region\n",
+                      (unsigned long)elapsedSlots);
+        return planFull(m, newIdx, newLooped, ranges);
+    }
+
+    // The newest slot at last sync (idx - 1) was still accumulating, so
+    // re-read it along with everything written since.
+    uint16_t first;
+    if (m.idx > 0)
+        first = m.idx - 1;
+    else if (m.looped)
+        first = words - 1;
+    else
+        first = 0;
+
+    uint16_t count = (newIdx + words - first) % words;
+    if (count == 0)
+        return 0;
+
+    if (first + count <= words)
+    {
+        ranges[0].address = m.startAddr + 2 * first;
+        ranges[0].size = 2 * count;
+        return 1;
+    }
+
+    // Split at the end of the ring
+    ranges[0].address = m.startAddr + 2 * first;
+    ranges[0].size = 2 * (words - first);
+    ranges[1].address = m.startAddr;
+    ranges[1].size = 2 * (first + count - words);
+    return 2;
+}
+
+bool mirrorStore(RingMirror &m, const FetchRange &range,
+                 const uint8_t *data, uint16_t len)
+{
+    if (range.address < m.startAddr)
+        return false;
+    uint16_t offset = range.address - m.startAddr;
+    if (len > range.size)
+        len = range.size;
+    if ((uint32_t)offset + len > m.regionSize)
+        return false;
+    memcpy(m.data + offset, data, len);
+    if (len > 0)
+    {
+        uint8_t firstPage = offset / MIRROR_PAGE_SIZE;
+        uint8_t lastPage = (offset + len - 1) / MIRROR_PAGE_SIZE;
+        for (uint8_t p = firstPage; p <= lastPage && p < MIRROR_MAX_PAGES; p++)
+            m.dirtyPages |= (1UL << p);
+    }
+    return true;
+}
+
+void mirrorCommit(RingMirror &m, uint16_t newIdx, bool newLooped)
+{
+    m.idx = newIdx;
+    m.looped = newLooped;
+    m.valid = true;
+    m.syncedAt = millis();
+    m.syncedEpoch = (uint32_t)timeNow();
+    m.metaDirty = true;
+}
+
+void mirrorCopy(RingMirror &dst, const RingMirror &src)
+{
+    uint8_t *storage = dst.data;
+    dst = src;
+    dst.data = storage;
+    memcpy(dst.data, src.data, src.regionSize);
+}
+
+uint16_t mirrorEntryCount(const RingMirror &m)
+{
+    if (!m.valid)
+        return 0;
+    uint16_t words = m.regionSize / 2;
+    if (m.looped || m.idx > words)
+        return words;
+    return m.idx;
+}
+
+uint8_t mirrorPageCount(const RingMirror &m)
+{
+    return (m.regionSize + MIRROR_PAGE_SIZE - 1) / MIRROR_PAGE_SIZE;
+}
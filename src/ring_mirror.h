@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdint.h>
+
+// A delta can wrap past the end of the ring, so it needs at most two reads
+#define MIRROR_MAX_RANGES 2
+
+// mirrorPlanFetch() result when the device reports an impossible write index
+#define MIRROR_PLAN_INVALID 0xFF
+
+// Granularity of dirty tracking for the flash copy (see mirror_store.h)
+#define MIRROR_PAGE_SIZE 256
+#define MIRROR_MAX_PAGES 32 // one bit each in RingMirror::dirtyPages
+
+struct FetchRange
+{
+    uint16_t address; // device byte address (as sent in the trigger command)
+    uint16_t size;    // bytes to request
+};
+
+struct RingMirror
+{
+    uint16_t startAddr;      // device address of the region start
+    uint16_t regionSize;     // region size in bytes (2 bytes per word)
+    uint32_t slotPeriodMs;   // how often the device advances the write index
+    uint8_t *data;           // local copy of the raw region (device byte order)
+    uint16_t idx;            // device write index at last successful sync
+    bool looped;             // device looped flag at last successful sync
+    bool valid;              // data matches the device as of idx/looped
+    unsigned long syncedAt;  // millis() of last successful sync
+    uint32_t syncedEpoch;    // wall-clock time of last sync (0 if unknown)
+    uint32_t dirtyPages;     // pages changed since the last flash save
+    bool metaDirty;          // idx/looped/valid changed since the last save
+};
+
+/**
+ * Initialize a mirror over caller-owned storage of `regionSize` bytes.
+ * The mirror starts invalid, so the first plan is a full fetch.
+ */
+void mirrorInit(RingMirror &m, uint16_t startAddr, uint16_t regionSize,
+                uint32_t slotPeriodMs, uint8_t *storage);
+
+/**
+ * Drop the mirror contents; the next plan will be a full fetch.
+ */
+void mirrorInvalidate(RingMirror &m);
+
+/**
+ * Plan the device reads needed to bring the mirror up to `newIdx`/`newLooped`.
+ * When the mirror is valid only the slots written since the last sync are
+ * requested, including the previously newest (still accumulating) slot.
+ * Falls back to a full-region plan if the mirror is invalid, the device ring
+ * was reset, or enough time has passed for the ring to have wrapped.
+ * Writes up to MIRROR_MAX_RANGES entries into `ranges`, returns the count,
+ * or MIRROR_PLAN_INVALID if `newIdx` lies outside the region (nothing to
+ * fetch, and the index must not be committed).
+ */
+uint8_t mirrorPlanFetch(const RingMirror &m, uint16_t newIdx, bool newLooped,
+                        FetchRange *ranges);
+
+/**
+ * Copy fetched bytes for `range` into the mirror.
+ * Returns false if the range lies outside the region.
+ */
+bool mirrorStore(RingMirror &m, const FetchRange &range,
+                 const uint8_t *data, uint16_t len);
+
+/**
+ * Mark the mirror as synced to `newIdx`/`newLooped`.
+ * Call only after every planned range was stored successfully.
+ */
+void mirrorCommit(RingMirror &m, uint16_t newIdx, bool newLooped);
+
+/**
+ * Copy `src` (metadata and region bytes) into `dst`, which must have been
+ * initialized over its own storage for the same region. Dirty flags are
+ * copied too; `dst` is a read-only view and is never saved.
+ */
+void mirrorCopy(RingMirror &dst, const RingMirror &src);
+
+/**
+ * Number of valid words in the mirror (whole ring once looped), never more
+ * than the region holds.
+ */
+uint16_t mirrorEntryCount(const RingMirror &m);
+
+/**
+ * Number of MIRROR_PAGE_SIZE pages covering the region.
+ */
+uint8_t mirrorPageCount(const RingMirror &m);
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdint.h>
+#include "bwt_regions.h"
+#include "ring_mirror.h"
+#include "utils.h"
+#include "word_decode.h"
+
+// The flash copy tracks dirty pages in one 32-bit mask
+static_assert(QhRegion::bytes <= MIRROR_PAGE_SIZE * MIRROR_MAX_PAGES &&
+                  DailyRegion::bytes <= MIRROR_PAGE_SIZE * MIRROR_MAX_PAGES,
+              "region exceeds the mirror's dirty-page tracking");
+
+/**
+ * Read-only view of a synced ring mirror of region R in chronological
+ * terms. Entries are decoded from the raw device words on access, so
+ * nothing is copied, rotated or reversed. The mirror must outlive the view.
+ */
+template <typename R>
+struct RingView
+{
+    const uint8_t *data; // raw region (big-endian words)
+    uint16_t count;      // valid entries (0 if the mirror is invalid)
+    uint16_t newest;     // word position of the newest (in-progress) slot
+};
+
+/**
+ * View over `m`, a mirror of region R, as of its last sync. The device
+ * writes at `m.idx`; the slot before it is the newest and, once looped,
+ * `m.idx` is the oldest.
+ */
+template <typename R>
+inline RingView<R> ringView(const RingMirror &m)
+{
+    RingView<R> v;
+    v.data = m.data;
+    v.count = m.regionSize == R::bytes ? mirrorEntryCount(m) : 0;
+    v.newest = (m.idx + R::words - 1) % R::words;
+    return v;
+}
+
+/**
+ * Word position of the k-th newest entry (k = 0 is the newest).
+ */
+template <typename R>
+inline uint16_t ringPosNewest(const RingView<R> &v, uint16_t k)
+{
+    return k <= v.newest ? v.newest - k : v.newest + R::words - k;
+}
+
+/**
+ * The k-th newest word, k < count.
+ */
+template <typename R>
+inline RegionWord<R> ringWord(const RingView<R> &v, uint16_t k)
+{
+    return {readUint16BE(v.data, ringPosNewest(v, k) * 2)};
+}
+
+/**
+ * Litres of the k-th newest entry, k < count. Decodes only that field.
+ */
+template <typename R>
+inline uint16_t ringLitres(const RingView<R> &v, uint16_t k)
+{
+    return ringWord(v, k).litres();
+}
+
+/**
+ * Litres of a run of up to `n` entries starting at the k-th newest and
+ * going back in time, batch-decoded into `out` oldest first (so out[0]
+ * is the oldest of the run). Runs stop where the ring wraps.
+ * Returns the number of entries written.
+ */
+template <typename R>
+inline uint16_t ringLitresRun(const RingView<R> &v, uint16_t k, uint16_t n, uint16_t *out)
+{
+    if (k >= v.count)
+        return 0;
+    uint16_t pos = ringPosNewest(v, k);
+    if (n > v.count - k)
+        n = v.count - k;
+    if (n > pos + 1)
+        n = pos + 1;
+    decodeWords(v.data + (pos + 1 - n) * 2, n, R::litresMask, R::litresScale, out);
+    return n;
+}
+
+/**
+ * The k-th newest entry with all fields decoded, k < count.
+ */
+template <typename R>
+inline ConsumptionEntry ringNewest(const RingView<R> &v, uint16_t k)
+{
+    return ringWord(v, k).entry();
+}
+
+/**
+ * The k-th oldest entry, k < count.
+ */
+template <typename R>
+inline ConsumptionEntry ringOldest(const RingView<R> &v, uint16_t k)
+{
+    return ringNewest(v, v.count - 1 - k);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * Fixed-size lock-free single-producer/single-consumer ring.
+ * push() may only be called from one task and pop() from one other task.
+ * N must be a power of two; one slot is never used so full != empty.
+ *
+ * Indices are 32-bit so that loads/stores are native atomics on the ESP32.
+ */
+template <typename T, uint32_t N>
+struct SpscRing
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+    T items[N];
+    std::atomic<uint32_t> head{0}; // next slot to write (owned by producer)
+    std::atomic<uint32_t> tail{0}; // next slot to read (owned by consumer)
+
+    /**
+     * Producer side. Returns false (item dropped) if the ring is full.
+     */
+    bool push(const T &item)
+    {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t next = (h + 1) & (N - 1);
+        if (next == tail.load(std::memory_order_acquire))
+            return false;
+        items[h] = item;
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer side. Returns false if the ring is empty.
+     */
+    bool pop(T &item)
+    {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+            return false;
+        item = items[t];
+        tail.store((t + 1) & (N - 1), std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Consumer side. Discard everything currently queued.
+     */
+    void clear()
+    {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+};
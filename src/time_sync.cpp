@@ -0,0 +1,183 @@
+#include "time_sync.h"
+#include "config.h"
+
+#include <Arduino.h>
+#include <esp_sntp.h>
+#include <sys/time.h>
+#include <math.h>
+#include <stdlib.h>
+
+// Anything earlier means the clock has not been set by NTP yet
+#define TIME_MIN_VALID_EPOCH 1700000000L
+
+// Gap after a sync attempt that timed out before the next one (ms)
+#define TIME_RETRY_MS 60000
+static_assert(TIME_RETRY_MS > NTP_SYNC_TIMEOUT_MS, "retry before the last attempt timed out");
+
+// Assumed clock error until two syncs have measured it (ppm)
+#define TIME_DEFAULT_DRIFT_PPM 20
+
+// ─── Module State ───────────────────────────────────────────
+// Owned by the network task. RTC memory: the system clock keeps running
+// through deep sleep, and so does what is known about its accuracy.
+
+RTC_DATA_ATTR static bool s_synced = false;          // at least one sync
+RTC_DATA_ATTR static int64_t s_lastSyncEpochMs = 0;  // NTP time at the last sync
+RTC_DATA_ATTR static float s_driftPpm = TIME_DEFAULT_DRIFT_PPM;
+
+// Latest sync as reported by the SNTP callback (lwIP task), handed over
+// to the network task under s_syncLock
+static portMUX_TYPE s_syncLock = portMUX_INITIALIZER_UNLOCKED;
+static int64_t s_reportedEpochMs = 0;
+static unsigned long s_reportedMillis = 0; // millis() when it was reported
+static uint32_t s_reportedCount = 0;       // bumped on every sync
+static uint32_t s_appliedCount = 0;        // last count the network task applied
+
+// Local clock reading taken just before a sync we asked for
+static bool s_requestPending = false;
+static int64_t s_requestLocalMs = 0;
+static unsigned long s_requestMillis = 0;
+
+// Sync started by timeService()
+static bool s_inFlight = false;
+static unsigned long s_attemptAt = 0; // millis() of the last attempt
+static bool s_lastFailed = false;     // the last attempt timed out
+
+// ─── Helpers ────────────────────────────────────────────────
+
+static int64_t localEpochMs()
+{
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+// lwIP task: only record the sync, the network task takes it from here
+static void onTimeSync(struct timeval *tv)
+{
+    portENTER_CRITICAL(&s_syncLock);
+    s_reportedEpochMs = (int64_t)tv->tv_sec * 1000 + tv->tv_usec / 1000;
+    s_reportedMillis = millis();
+    s_reportedCount++;
+    portEXIT_CRITICAL(&s_syncLock);
+}
+
+// Take over a sync the callback reported. Returns false if there was none.
+static bool applyReportedSync()
+{
+    portENTER_CRITICAL(&s_syncLock);
+    uint32_t count = s_reportedCount;
+    int64_t epochMs = s_reportedEpochMs;
+    unsigned long reportedAt = s_reportedMillis;
+    portEXIT_CRITICAL(&s_syncLock);
+    if (count == s_appliedCount)
+        return false;
+    s_appliedCount = count;
+
+    // What the local clock would have read at the sync had NTP not
+    // stepped it: the gap to NTP is the error accumulated since the last one
+    if (s_requestPending && s_synced)
+    {
+        int64_t local = s_requestLocalMs + (int64_t)(reportedAt - s_requestMillis);
+        int64_t elapsed = local - s_lastSyncEpochMs;
+        if (elapsed >= 600000) // too short an interval is just NTP jitter
+        {
+            int64_t correction = epochMs - local;
+            s_driftPpm = (float)correction * 1e6f / (float)elapsed;
+            Serial.printf("[NTP] Clock corrected by %ld ms after %ld s (%.1f ppm)\n",
+                          (long)correction, (long)(elapsed / 1000), s_driftPpm);
+        }
+    }
+
+    s_requestPending = false;
+    s_lastSyncEpochMs = epochMs;
+    s_synced = true;
+    return true;
+}
+
+static bool syncDue()
+{
+    if (!s_synced)
+        return true;
+
+    int64_t elapsed = localEpochMs() - s_lastSyncEpochMs;
+    if (elapsed < 0 || elapsed >= (int64_t)NTP_RESYNC_HOURS * 3600000)
+        return true;
+
+    float driftMs = fabsf(s_driftPpm) * (float)elapsed / 1e6f;
+    return driftMs >= NTP_MAX_DRIFT_MS;
+}
+
+static void logTime(const char *label)
+{
+    time_t now = time(nullptr);
+    struct tm ti;
+    localtime_r(&now, &ti);
+    char buf[32];
+    strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &ti);
+    Serial.printf("[NTP] %s: %s\n", label, buf);
+}
+
+// ─── Public Functions ───────────────────────────────────────
+
+void timeInit()
+{
+    setenv("TZ", NTP_TZ, 1);
+    tzset();
+    sntp_set_time_sync_notification_cb(onTimeSync);
+}
+
+bool timeValid()
+{
+    return s_synced || time(nullptr) > TIME_MIN_VALID_EPOCH;
+}
+
+void timeService()
+{
+    bool synced = applyReportedSync();
+    if (s_inFlight)
+    {
+        if (synced)
+        {
+            logTime("Time synced");
+        }
+        else if (millis() - s_attemptAt < NTP_SYNC_TIMEOUT_MS)
+        {
+            return;
+        }
+        else if (timeValid())
+        {
+            // Keep running on the local clock; retried after TIME_RETRY_MS
+            Serial.println("[NTP] Sync timed out, keeping local time");
+        }
+        else
+        {
+            Serial.println("[NTP] Warning: time sync failed, dates will be wrong");
+        }
+        // Left running, SNTP would keep polling on its own interval (hourly
+        // by default); when to sync next is decided by syncDue()
+        sntp_stop();
+        s_lastFailed = !synced;
+        s_inFlight = false;
+        return;
+    }
+
+    // syncDue() stays true after a failure: hold off instead of
+    // restarting SNTP on every loop pass
+    if (!syncDue() || (s_lastFailed && millis() - s_attemptAt < TIME_RETRY_MS))
+        return;
+
+    s_requestLocalMs = localEpochMs();
+    s_requestMillis = millis();
+    s_requestPending = true;
+    configTzTime(NTP_TZ, NTP_SERVER);
+    Serial.println("[NTP] Syncing time...");
+    s_attemptAt = millis();
+    s_inFlight = true;
+}
+
+time_t timeNow()
+{
+    time_t now = time(nullptr);
+    return now > TIME_MIN_VALID_EPOCH ? now : 0;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * Apply NTP_TZ and hook the SNTP sync notification. Call once in setup().
+ */
+void timeInit();
+
+/**
+ * True once the system clock has been set by NTP.
+ */
+bool timeValid();
+
+/**
+ * Drive NTP from the network task's loop while WiFi is up. Never blocks.
+ * Starts a sync when one is due: there has been none yet, the last one is
+ * older than NTP_RESYNC_HOURS, or the drift estimated from earlier syncs
+ * has grown past NTP_MAX_DRIFT_MS. A sync that gets no answer within
+ * NTP_SYNC_TIMEOUT_MS is abandoned and retried a minute later; the system
+ * clock keeps running meanwhile, including while WiFi is off. SNTP is
+ * stopped between syncs, so its own update interval never applies.
+ */
+void timeService();
+
+/**
+ * Current wall-clock time, or 0 if the clock has never been set.
+ */
+time_t timeNow();
@@ -0,0 +1,153 @@
+#include "timeline.h"
+#include <string.h>
+
+// The offset is assumed constant within a chunk when both ends agree;
+// real DST rules never change it twice within two weeks
+#define TIMELINE_CHUNK_S (14L * 86400)
+// Give up looking for an earlier transition after this many chunks
+// (zones without DST); the search resumes when a step goes past it
+#define TIMELINE_SEARCH_CHUNKS 27
+
+// ─── Helpers ────────────────────────────────────────────────
+
+// Days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant's algorithm)
+static int32_t daysFromCivil(int32_t y, uint32_t m, uint32_t d)
+{
+    y -= m <= 2;
+    const int32_t era = (y >= 0 ? y : y - 399) / 400;
+    const uint32_t yoe = (uint32_t)(y - era * 400);
+    const uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+static void civilFromDays(int32_t z, int32_t &y, uint32_t &m, uint32_t &d)
+{
+    z += 719468;
+    const int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const uint32_t doe = (uint32_t)(z - era * 146097);
+    const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const uint32_t mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = (int32_t)yoe + era * 400 + (m <= 2);
+}
+
+// UTC offset in effect at `t`, from the C library's TZ rules
+static int32_t offsetAt(time_t t)
+{
+    struct tm lt;
+    localtime_r(&t, &lt);
+    int64_t local = (int64_t)daysFromCivil(lt.tm_year + 1900, lt.tm_mon + 1, lt.tm_mday) * 86400 +
+                    lt.tm_hour * 3600 + lt.tm_min * 60 + lt.tm_sec;
+    return (int32_t)(local - (int64_t)t);
+}
+
+// Earliest time from which `offset` (in effect at `at`) holds up to `at`
+static time_t offsetStart(time_t at, int32_t offset)
+{
+    time_t hi = at;
+    for (uint8_t i = 0; i < TIMELINE_SEARCH_CHUNKS; i++)
+    {
+        time_t lo = hi - TIMELINE_CHUNK_S;
+        if (offsetAt(lo) == offset)
+        {
+            hi = lo;
+            continue;
+        }
+        // Transition in (lo, hi]: narrow it down to the second
+        while (hi - lo > 1)
+        {
+            time_t mid = lo + (hi - lo) / 2;
+            if (offsetAt(mid) == offset)
+                hi = mid;
+            else
+                lo = mid;
+        }
+        return hi;
+    }
+    return hi;
+}
+
+static inline void put2(char *p, uint32_t v)
+{
+    p[0] = '0' + v / 10;
+    p[1] = '0' + v % 10;
+}
+
+// Re-derive the local fields from `at`/`offset`
+static void updateLocal(Timeline &tl)
+{
+    int64_t wall = (int64_t)tl.at + tl.offset;
+    int32_t day = (int32_t)(wall / 86400);
+    if (wall % 86400 < 0)
+        day--;
+    tl.secOfDay = (int32_t)(wall - (int64_t)day * 86400);
+    if (day == tl.day && tl.date[0] != '\0')
+        return;
+
+    tl.day = day;
+    int32_t y;
+    uint32_t m, d;
+    civilFromDays(day, y, m, d);
+    put2(tl.date, (uint32_t)y / 100 % 100);
+    put2(tl.date + 2, (uint32_t)y % 100);
+    tl.date[4] = '-';
+    put2(tl.date + 5, m);
+    tl.date[7] = '-';
+    put2(tl.date + 8, d);
+    tl.date[10] = '\0';
+}
+
+// ─── Public Functions ───────────────────────────────────────
+
+void timelineInit(Timeline &tl, const struct tm &local)
+{
+    struct tm copy = local;
+    tl.at = mktime(&copy);
+    tl.offset = offsetAt(tl.at);
+    tl.offsetSince = offsetStart(tl.at, tl.offset);
+    tl.date[0] = '\0';
+    updateLocal(tl);
+}
+
+void timelineStepBack(Timeline &tl, uint32_t seconds)
+{
+    tl.at -= seconds;
+    if (tl.at < tl.offsetSince)
+    {
+        tl.offset = offsetAt(tl.at);
+        tl.offsetSince = offsetStart(tl.at, tl.offset);
+    }
+    updateLocal(tl);
+}
+
+void timelineStartOfDay(Timeline &tl)
+{
+    int32_t day = tl.day;
+    timelineStepBack(tl, tl.secOfDay);
+    if (tl.day == day && tl.secOfDay > 0)
+    {
+        // Clocks went back during the day: midnight is earlier still
+        timelineStepBack(tl, tl.secOfDay);
+    }
+    else if (tl.day != day)
+    {
+        // Clocks went forward during the day: midnight is later
+        tl.at += 86400 - tl.secOfDay;
+        tl.offset = offsetAt(tl.at);
+        tl.offsetSince = offsetStart(tl.at, tl.offset);
+        updateLocal(tl);
+    }
+}
+
+void timelineFormatMinute(const Timeline &tl, char *buf)
+{
+    memcpy(buf, tl.date, 10);
+    buf[10] = 'T';
+    put2(buf + 11, tl.secOfDay / 3600);
+    buf[13] = ':';
+    put2(buf + 14, tl.secOfDay / 60 % 60);
+    buf[16] = '\0';
+}
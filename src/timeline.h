@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * Cursor that walks local time backwards for history labels, without a
+ * mktime()/strftime() per bucket. The UTC offset is only looked up again
+ * when a step crosses the last known transition of NTP_TZ's DST rules, and
+ * the date string only changes when the step crosses midnight.
+ */
+struct Timeline
+{
+    time_t at;          // current position (UTC epoch)
+    int32_t offset;     // UTC offset at `at` (seconds, local = UTC + offset)
+    time_t offsetSince; // earliest time `offset` is known to hold from
+    int32_t day;        // local date as days since 1970-01-01
+    int32_t secOfDay;   // local seconds since midnight
+    char date[11];      // "YYYY-MM-DD" of `day`
+};
+
+/**
+ * Start at the local time `local` (as filled by localtime_r()).
+ */
+void timelineInit(Timeline &tl, const struct tm &local);
+
+/**
+ * Move `seconds` of real time into the past. Across a DST change the local
+ * clock moves by one hour more or less than that, as on the wall.
+ */
+void timelineStepBack(Timeline &tl, uint32_t seconds);
+
+/**
+ * Move to the first second of the current local day, i.e. local midnight
+ * (or the first existing time after it on a changeover day).
+ */
+void timelineStartOfDay(Timeline &tl);
+
+/**
+ * Write the local time as "YYYY-MM-DDTHH:MM". `buf` needs 17 bytes.
+ */
+void timelineFormatMinute(const Timeline &tl, char *buf);
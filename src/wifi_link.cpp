@@ -0,0 +1,123 @@
+#include "wifi_link.h"
+#include "config.h"
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <string.h>
+
+#define WIFI_LINK_MAGIC 0x4B4E4C57 // "WLNK"
+
+// Last good association, kept in RTC memory so it also survives deep sleep
+struct WifiLinkCache
+{
+    uint32_t magic;
+    uint8_t bssid[6];
+    int32_t channel;
+};
+
+// ─── Module State ───────────────────────────────────────────
+
+RTC_DATA_ATTR static WifiLinkCache s_cache;
+
+// Connect in progress
+enum ConnectPhase
+{
+    PHASE_NONE,
+    PHASE_FAST, // cached BSSID/channel, no scan
+    PHASE_FULL, // scan + DHCP
+};
+static ConnectPhase s_phase = PHASE_NONE;
+static unsigned long s_start = 0;
+static unsigned long s_phaseStart = 0;
+static uint32_t s_timeoutMs = 0;
+
+// ─── Helpers ────────────────────────────────────────────────
+
+static void recordLink()
+{
+    uint8_t *bssid = WiFi.BSSID();
+    if (!bssid)
+        return;
+    memcpy(s_cache.bssid, bssid, sizeof(s_cache.bssid));
+    s_cache.channel = WiFi.channel();
+    s_cache.magic = WIFI_LINK_MAGIC;
+}
+
+static void beginFast()
+{
+    // Straight to the known AP, no scan. The address still comes from
+    // DHCP: only the server knows how long a lease stays ours
+    WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD, s_cache.channel, s_cache.bssid);
+    s_phase = PHASE_FAST;
+    s_phaseStart = millis();
+}
+
+static void beginFull()
+{
+    WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+    s_phase = PHASE_FULL;
+    s_phaseStart = millis();
+}
+
+// ─── Public Functions ───────────────────────────────────────
+
+void wifiConnectStart(uint32_t timeoutMs)
+{
+    WiFi.persistent(false); // credentials come from config.h, skip NVS writes
+    WiFi.mode(WIFI_STA);
+    if (WIFI_BLE_COEXIST)
+        WiFi.setSleep(true); // modem sleep is required while BLE shares the radio
+
+    s_start = millis();
+    s_timeoutMs = timeoutMs;
+    if (s_cache.magic == WIFI_LINK_MAGIC)
+        beginFast();
+    else
+        beginFull();
+}
+
+WifiLinkState wifiConnectStep()
+{
+    if (s_phase == PHASE_NONE)
+        return WiFi.status() == WL_CONNECTED ? WIFI_LINK_UP : WIFI_LINK_FAILED;
+
+    unsigned long now = millis();
+    if (WiFi.status() == WL_CONNECTED)
+    {
+        bool fast = s_phase == PHASE_FAST;
+        recordLink();
+        if (fast)
+            Serial.printf("[WiFi] Fast reconnect in %lu ms (channel %ld)\n",
+                          now - s_start, (long)s_cache.channel);
+        else
+            Serial.printf("[WiFi] Connected in %lu ms\n", now - s_start);
+        s_phase = PHASE_NONE;
+        return WIFI_LINK_UP;
+    }
+
+    if (s_phase == PHASE_FAST &&
+        now - s_phaseStart >= min((uint32_t)WIFI_FAST_CONNECT_TIMEOUT_MS, s_timeoutMs))
+    {
+        // AP moved channel or was replaced
+        Serial.println("[WiFi] Fast reconnect failed, doing a full scan");
+        s_cache.magic = 0;
+        WiFi.disconnect();
+        beginFull();
+    }
+
+    if (now - s_start >= s_timeoutMs)
+    {
+        s_phase = PHASE_NONE;
+        return WIFI_LINK_FAILED;
+    }
+    return WIFI_LINK_PENDING;
+}
+
+void wifiOff()
+{
+    s_phase = PHASE_NONE;
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+}
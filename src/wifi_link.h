@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+
+enum WifiLinkState
+{
+    WIFI_LINK_PENDING, // still associating
+    WIFI_LINK_UP,
+    WIFI_LINK_FAILED, // timed out
+};
+
+/**
+ * Start connecting the station to WIFI_SSID without waiting; drive it with
+ * wifiConnectStep(). Reuses the AP (BSSID + channel) recorded on the last
+ * successful connect, which skips the channel scan; the address always
+ * comes from DHCP. If that fast path fails, the cache is dropped and a
+ * normal scan + DHCP connect runs, all within `timeoutMs`.
+ */
+void wifiConnectStart(uint32_t timeoutMs);
+
+/**
+ * Advance a connect started by wifiConnectStart(). Never blocks.
+ */
+WifiLinkState wifiConnectStep();
+
+/**
+ * Switch WiFi off, e.g. to hand the radio to BLE. The cached link is kept.
+ */
+void wifiOff();
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// Batch decoding of big-endian device words: byte swap, mask and scale.
+// No framework dependencies, so the same kernel builds for the ESP32 and
+// for host-side tools decoding many devices' dumps.
+
+#if UINTPTR_MAX > 0xFFFFFFFFu
+typedef uint64_t DecodeLane; // 4 words per load on 64-bit hosts
+#else
+typedef uint32_t DecodeLane; // 2 words per load on the ESP32
+#endif
+
+/**
+ * Reference decoder, one word at a time:
+ * out[i] = scale * (BE word i of src & mask).
+ */
+inline void decodeWordsScalar(const uint8_t *src, uint16_t n, uint16_t mask,
+                              uint16_t scale, uint16_t *out)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        uint16_t word = ((uint16_t)src[2 * i] << 8) | src[2 * i + 1];
+        out[i] = scale * (word & mask);
+    }
+}
+
+/**
+ * decodeWords() with an explicit lane type, so host tests can run the
+ * ESP32's 32-bit lanes as well as the native ones.
+ */
+template <typename Lane>
+inline void decodeWordsLanes(const uint8_t *src, uint16_t n, uint16_t mask,
+                             uint16_t scale, uint16_t *out)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    constexpr uint16_t laneWords = sizeof(Lane) / 2;
+    constexpr Lane rep = (Lane)~(Lane)0 / 0xFFFF; // 0x0001 in every lane
+    constexpr Lane lo = rep * 0x00FF;
+    const Lane lanesMask = (Lane)mask * rep;
+    uint16_t i = 0;
+    for (; i + laneWords <= n; i += laneWords)
+    {
+        Lane x;
+        memcpy(&x, src + 2 * i, sizeof(x));
+        // Swap the bytes of every 16-bit lane, then mask and scale them all
+        x = (Lane)(((x & lo) << 8) | ((x >> 8) & lo));
+        x = (Lane)((x & lanesMask) * scale);
+        memcpy(out + i, &x, sizeof(x));
+    }
+    decodeWordsScalar(src + 2 * i, n - i, mask, scale, out + i);
+#else
+    decodeWordsScalar(src, n, mask, scale, out);
+#endif
+}
+
+/**
+ * Same result as decodeWordsScalar(), several words per load. `src` and
+ * `out` need no particular alignment (lanes are moved with memcpy); the
+ * tail shorter than a lane goes through the scalar path. Requires
+ * scale * mask <= 0xFFFF so no lane carries into the next.
+ */
+inline void decodeWords(const uint8_t *src, uint16_t n, uint16_t mask,
+                        uint16_t scale, uint16_t *out)
+{
+    decodeWordsLanes<DecodeLane>(src, n, mask, scale, out);
+}
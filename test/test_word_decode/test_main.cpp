@@ -0,0 +1,123 @@
+// decodeWords() against the one-word-at-a-time reference, in both lane
+// widths: 64-bit as on the host and 32-bit as on the ESP32.
+//
+//   pio test -e native
+
+#include <unity.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "word_decode.h"
+
+// Litres field of a QH word and of a daily word (see bwt_regions.h)
+#define QH_MASK 0x3FF
+#define QH_SCALE 1
+#define DAILY_MASK 0x7FF
+#define DAILY_SCALE 10
+
+#define MAX_WORDS 80
+#define MAX_OFFSET 8
+
+static uint8_t s_src[MAX_OFFSET + 2 * MAX_WORDS];
+static uint16_t s_expected[MAX_WORDS + 1];
+static uint16_t s_actual[MAX_WORDS + 1];
+
+void setUp()
+{
+    // Fixed xorshift sequence, so a failure reproduces
+    uint32_t x = 0x2545F491u;
+    for (size_t i = 0; i < sizeof(s_src); i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        s_src[i] = (uint8_t)x;
+    }
+}
+
+void tearDown() {}
+
+typedef void (*DecodeFn)(const uint8_t *, uint16_t, uint16_t, uint16_t, uint16_t *);
+
+// Every source offset (alignment) and length, plus an output misaligned
+// by one word; the slot past the end must stay untouched
+static void checkAgainstScalar(DecodeFn decode, uint16_t mask, uint16_t scale)
+{
+    char msg[64];
+    for (uint8_t offset = 0; offset < MAX_OFFSET; offset++)
+    {
+        for (uint16_t n = 0; n <= MAX_WORDS; n++)
+        {
+            for (uint8_t outShift = 0; outShift < 2; outShift++)
+            {
+                const uint8_t *src = s_src + offset;
+                uint16_t *out = s_actual + outShift;
+                memset(s_actual, 0xA5, sizeof(s_actual));
+                decodeWordsScalar(src, n, mask, scale, s_expected);
+                decode(src, n, mask, scale, out);
+
+                snprintf(msg, sizeof(msg), "offset %u, n %u, out +%u",
+                         offset, n, outShift);
+                if (n > 0)
+                    TEST_ASSERT_EQUAL_HEX16_ARRAY_MESSAGE(s_expected, out, n, msg);
+                if (n + outShift <= MAX_WORDS)
+                    TEST_ASSERT_EQUAL_HEX16_MESSAGE(0xA5A5, out[n], msg);
+            }
+        }
+    }
+}
+
+void test_qh_lanes32()
+{
+    checkAgainstScalar(decodeWordsLanes<uint32_t>, QH_MASK, QH_SCALE);
+}
+
+void test_qh_lanes64()
+{
+    checkAgainstScalar(decodeWordsLanes<uint64_t>, QH_MASK, QH_SCALE);
+}
+
+void test_daily_lanes32()
+{
+    checkAgainstScalar(decodeWordsLanes<uint32_t>, DAILY_MASK, DAILY_SCALE);
+}
+
+void test_daily_lanes64()
+{
+    checkAgainstScalar(decodeWordsLanes<uint64_t>, DAILY_MASK, DAILY_SCALE);
+}
+
+// Largest field values: the scaled result fills a lane without carrying
+void test_full_fields()
+{
+    memset(s_src, 0xFF, sizeof(s_src));
+    checkAgainstScalar(decodeWordsLanes<uint32_t>, DAILY_MASK, DAILY_SCALE);
+    checkAgainstScalar(decodeWordsLanes<uint64_t>, DAILY_MASK, DAILY_SCALE);
+
+    uint16_t out[4];
+    decodeWords(s_src, 4, DAILY_MASK, DAILY_SCALE, out);
+    TEST_ASSERT_EACH_EQUAL_UINT16(DAILY_SCALE * DAILY_MASK, out, 4);
+}
+
+void test_default_lanes()
+{
+    checkAgainstScalar(decodeWords, QH_MASK, QH_SCALE);
+    checkAgainstScalar(decodeWords, DAILY_MASK, DAILY_SCALE);
+}
+
+static int runTests()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_qh_lanes32);
+    RUN_TEST(test_qh_lanes64);
+    RUN_TEST(test_daily_lanes32);
+    RUN_TEST(test_daily_lanes64);
+    RUN_TEST(test_full_fields);
+    RUN_TEST(test_default_lanes);
+    return UNITY_END();
+}
+
+int main()
+{
+    return runTests();
+}